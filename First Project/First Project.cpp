@@ -1,12 +1,31 @@
 ﻿#include <iostream>
 #include <chrono>
+#include <cstddef>
 #include <random>
 #include <iomanip>
+#include <cstdio>
 #include <cstring>
 #include <string>
+#include <stdexcept>
+#include <vector>
+#include <functional>
 #include "MergeSort.hpp"
 #include "QuickSort.hpp"
 #include "IntroSort.hpp"
+#include "parallelIntroSort.hpp"
+#include "radixSort.hpp"
+#include "pdqSort.hpp"
+#include "timSort.hpp"
+#include "selection.hpp"
+#include "indirectSort.hpp"
+#include "stringSort.hpp"
+#include "staticSort.hpp"
+#include "kWayMerge.hpp"
+#include "blockMergeSort.hpp"
+#include "sortInstrumentation.hpp"
+#include "benchmarkHarness.hpp"
+#include "datasets.hpp"
+#include "externalSort.hpp"
 
 int* generateRandomArray(int arraySize, int seed) {
     std::mt19937 generator(seed);
@@ -40,6 +59,40 @@ int* generateReverseSortedArray(int arraySize) {
     return arr;
 }
 
+// Adresy URL z dlugim wspolnym prefiksem i kilkoma poziomami sciezki.
+std::vector<std::string> generateUrlArray(int arraySize, int seed) {
+    static const char* const sections[] = { "products", "category", "search", "user", "static/img", "blog/posts" };
+    std::mt19937 generator(seed);
+    std::vector<std::string> arr(arraySize);
+    for (std::string& url : arr) {
+        url = "https://www.example.com/";
+        url += sections[generator() % 6];
+        url += '/';
+        url += std::to_string(generator() % 1000);
+        url += "/item-";
+        url += std::to_string(generator() % 1000000);
+    }
+    return arr;
+}
+
+// Klucze logow: znacznik czasu z jednego dnia, nazwa uslugi i identyfikator zdarzenia.
+std::vector<std::string> generateLogKeyArray(int arraySize, int seed) {
+    static const char* const services[] = { "auth", "billing", "gateway", "search", "storage" };
+    std::mt19937 generator(seed);
+    std::vector<std::string> arr(arraySize);
+    char timestamp[32];
+    for (std::string& key : arr) {
+        unsigned seconds = generator() % 86400;
+        std::snprintf(timestamp, sizeof(timestamp), "2024-05-17T%02u:%02u:%02u.%03u|",
+                      seconds / 3600, seconds / 60 % 60, seconds % 60, static_cast<unsigned>(generator() % 1000));
+        key = timestamp;
+        key += services[generator() % 5];
+        key += '|';
+        key += std::to_string(generator());
+    }
+    return arr;
+}
+
 int* copyArray(const int* original, int arraySize) {
     int* copy = new (std::nothrow) int[arraySize];
     if (!copy) throw std::bad_alloc();
@@ -72,71 +125,522 @@ double runSortExperiment(SortFunc sortFunc, int* baseArrays[], int arraySize, in
     return totalTime / repeatCount;
 }
 
-template <typename SortFunc>
-void runExperimentForAllCases(const std::string& sortName, SortFunc sortFunc) {
-    constexpr int arraySizes[] = { 100, 500, 1000, 5000, 10000, 50000, 100000, 250000, 500000, 1000000 };
-    constexpr double percentages[] = { 0.25, 0.5, 0.75, 0.95, 0.99, 0.997 };
-    constexpr int numSizes = sizeof(arraySizes) / sizeof(arraySizes[0]);
-    constexpr int numPercents = sizeof(percentages) / sizeof(percentages[0]);
+// std::less zamiast lambdy: tylko z nim scalanie idzie przez simdMerge (AVX2/AVX-512).
+void mergeSortWrapper(int* arr, int size) {
+    mergeSort<int>(arr, size, std::less<int>{});
+}
+
+void mergeSortBottomUpWrapper(int* arr, int size) {
+    mergeSortBottomUp<int>(arr, size, std::less<int>{});
+}
+
+void parallelMergeSortWrapper(int* arr, int size) {
+    parallelMergeSort<int>(arr, size, std::less<int>{});
+}
+
+void timSortWrapper(int* arr, int size) {
+    timSort<int>(arr, size, std::less<int>{});
+}
+
+// std::less zamiast lambdy, zeby male zakresy konczyla siec AVX2 (smallSort).
+void quickSortWrapper(int* arr, int size) {
+    quickSort<int>(arr, size, std::less<int>{});
+}
+
+void threeWayQuickSortWrapper(int* arr, int size) {
+    quickSort<int, std::less<int>, ThreeWayPartition>(arr, size);
+}
+
+void dualPivotQuickSortWrapper(int* arr, int size) {
+    quickSort<int, std::less<int>, DualPivotPartition>(arr, size);
+}
+
+// std::less zamiast lambdy: tylko z nim introSort przechodzi na americanFlagSort dla duzych tablic.
+void introSortWrapper(int* arr, int size) {
+    introSort<int>(arr, size, std::less<int>{});
+}
+
+void parallelIntroSortWrapper(int* arr, int size) {
+    parallelIntroSort<int>(arr, size, std::less<int>{});
+}
+
+void pdqSortWrapper(int* arr, int size) {
+    pdqSort<int>(arr, size, std::less<int>{});
+}
+
+void radixSortWrapper(int* arr, int size) {
+    radixSort<int>(arr, size);
+}
+
+void americanFlagSortWrapper(int* arr, int size) {
+    americanFlagSort<int>(arr, size);
+}
+
+// Algorytmy trybu bench pod nazwami uzywanymi w --algorithms.
+std::vector<std::pair<std::string, BenchmarkSort>> benchmarkAlgorithms() {
+    auto adapt = [](void (*sortFunc)(int*, int)) -> BenchmarkSort {
+        return [sortFunc](int* arr, std::size_t size) { sortFunc(arr, static_cast<int>(size)); };
+    };
+    return {
+        { "mergeSort", adapt(mergeSortWrapper) },
+        { "mergeSortBottomUp", adapt(mergeSortBottomUpWrapper) },
+        { "parallelMergeSort", adapt(parallelMergeSortWrapper) },
+        { "timSort", adapt(timSortWrapper) },
+        { "quickSort", adapt(quickSortWrapper) },
+        { "quickSort3Way", adapt(threeWayQuickSortWrapper) },
+        { "quickSortDualPivot", adapt(dualPivotQuickSortWrapper) },
+        { "introSort", adapt(introSortWrapper) },
+        { "parallelIntroSort", adapt(parallelIntroSortWrapper) },
+        { "pdqSort", adapt(pdqSortWrapper) },
+        { "radixSort", adapt(radixSortWrapper) },
+        { "americanFlagSort", adapt(americanFlagSortWrapper) },
+    };
+}
+
+// Rozklady trybu bench z datasets.hpp: losowy, czesciowo posortowane (partial25 .. partial99.7),
+// odwrotny, organ-pipe, pila, kilka kluczy i Zipf. Duze zbiory sa wczytywane z pamieci podrecznej.
+std::vector<std::pair<std::string, BenchmarkInput>> benchmarkDistributions() {
+    std::vector<std::pair<std::string, BenchmarkInput>> distributions;
+    for (const std::string& name : datasetDistributions()) {
+        distributions.push_back({ name, [name](std::size_t size, unsigned seed, const std::string& cacheDirectory) {
+            return loadDataset(name, size, seed, cacheDirectory);
+        } });
+    }
+    return distributions;
+}
+
+// Domyslnie wszystkie algorytmy i rozklady na dawnych rozmiarach, 10 powtorzen po 2 rozgrzewkowych.
+BenchmarkOptions defaultBenchmarkOptions() {
+    BenchmarkOptions options;
+    options.sizes = { 100, 500, 1000, 5000, 10000, 50000, 100000, 250000, 500000, 1000000 };
+    return options;
+}
+
+// Percentyle i top-k: pelne sortowanie introSort wobec wyboru w O(n) (introSelect),
+// partialSort z k = 100 i strumieniowego TopK na tych samych losowych tablicach.
+void runSelectionExperiment() {
+    constexpr int arraySizes[] = { 10000, 100000, 1000000 };
     constexpr int repeatCount = 10;
+    constexpr std::size_t topCount = 100;
+    auto less = [](int a, int b) { return a < b; };
 
-    std::cout << "===== " << sortName << " =====\n";
+    auto percentiles = [&](int* arr, int size) {
+        for (double p : { 0.5, 0.9, 0.99 }) {
+            introSelect<int>(arr, size, static_cast<std::size_t>(p * (size - 1)), less);
+        }
+    };
+    auto sortedPercentiles = [&](int* arr, int size) { introSort<int>(arr, size, less); };
+    auto partialTop = [&](int* arr, int size) { partialSort<int>(arr, size, topCount, less); };
+    auto streamingTop = [&](int* arr, int size) { topK<int>(arr, size, topCount, less); };
 
-    for (int s = 0; s < numSizes; ++s) {
-        int arraySize = arraySizes[s];
+    std::cout << "===== Percentyle i top-k =====\n";
+    for (int arraySize : arraySizes) {
         std::cout << "===== Rozmiar tablicy: " << arraySize << " =====\n";
 
         int* baseArrays[repeatCount];
         for (int i = 0; i < repeatCount; ++i)
             baseArrays[i] = generateRandomArray(arraySize, i);
 
-        double avgRandom = runSortExperiment(sortFunc, baseArrays, arraySize);
-        std::cout << "Losowe:           " << std::fixed << std::setprecision(2) << avgRandom << " ms\n";
+        std::cout << "Percentyle (introSort):   " << std::fixed << std::setprecision(2) << runSortExperiment(sortedPercentiles, baseArrays, arraySize) << " ms\n";
+        std::cout << "Percentyle (introSelect): " << std::fixed << std::setprecision(2) << runSortExperiment(percentiles, baseArrays, arraySize) << " ms\n";
+        std::cout << "Top 100 (partialSort):    " << std::fixed << std::setprecision(2) << runSortExperiment(partialTop, baseArrays, arraySize) << " ms\n";
+        std::cout << "Top 100 (TopK):           " << std::fixed << std::setprecision(2) << runSortExperiment(streamingTop, baseArrays, arraySize) << " ms\n";
 
-        for (int p = 0; p < numPercents; ++p) {
-            double percent = percentages[p];
+        for (int i = 0; i < repeatCount; ++i)
+            delete[] baseArrays[i];
+        std::cout << "\n";
+    }
+}
 
-            for (int i = 0; i < repeatCount; ++i) {
-                delete[] baseArrays[i];
-                baseArrays[i] = generatePartiallySortedArray(arraySize, percent, i);
-            }
+// Rekord o rozmiarze 200 bajtow z 32-bitowym kluczem.
+struct WideRecord {
+    int key;
+    char payload[196];
+};
 
-            double avg = runSortExperiment(sortFunc, baseArrays, arraySize);
-            std::cout << "Sort " << std::setw(4) << int(percent * 100) << "%:        " << std::fixed << std::setprecision(2) << avg << " ms\n";
-        }
+// Porownanie sortowania szerokich rekordow bezposrednio i przez pary (klucz, indeks).
+void runWideRecordExperiment() {
+    constexpr int arraySizes[] = { 10000, 100000, 1000000 };
+    constexpr int repeatCount = 5;
 
+    auto measure = [&](int* baseArrays[], int arraySize, auto sortFunc) {
+        double totalTime = 0.0;
         for (int i = 0; i < repeatCount; ++i) {
+            std::vector<WideRecord> records(arraySize);
+            for (int j = 0; j < arraySize; ++j) records[j].key = baseArrays[i][j];
+
+            auto start = std::chrono::high_resolution_clock::now();
+            sortFunc(records.data(), arraySize);
+            auto end = std::chrono::high_resolution_clock::now();
+            totalTime += std::chrono::duration<double, std::milli>(end - start).count();
+        }
+        return totalTime / repeatCount;
+    };
+    auto direct = [](WideRecord* arr, int size) {
+        introSort<WideRecord>(arr, size, [](const WideRecord& a, const WideRecord& b) { return a.key < b.key; });
+    };
+    auto byKey = [](WideRecord* arr, int size) {
+        sortByKey(arr, size, [](const WideRecord& record) { return record.key; });
+    };
+
+    std::cout << "===== Rekordy 200-bajtowe =====\n";
+    for (int arraySize : arraySizes) {
+        std::cout << "===== Rozmiar tablicy: " << arraySize << " =====\n";
+
+        int* baseArrays[repeatCount];
+        for (int i = 0; i < repeatCount; ++i)
+            baseArrays[i] = generateRandomArray(arraySize, i);
+
+        std::cout << "introSort rekordow: " << std::fixed << std::setprecision(2) << measure(baseArrays, arraySize, direct) << " ms\n";
+        std::cout << "sortByKey:          " << std::fixed << std::setprecision(2) << measure(baseArrays, arraySize, byKey) << " ms\n";
+
+        for (int i = 0; i < repeatCount; ++i)
             delete[] baseArrays[i];
-            baseArrays[i] = generateReverseSortedArray(arraySize);
+        std::cout << "\n";
+    }
+}
+
+// Czas i szczytowa pamiec pomocnicza sortowan stabilnych: mergeSort (bufor n), timSort (do n/2),
+// blockMergeSort z buforem sqrt(n), z buforem 512 elementow i bez bufora.
+void runLowMemoryExperiment() {
+    constexpr int arraySizes[] = { 100000, 1000000, 4000000 };
+    constexpr int repeatCount = 5;
+    auto less = [](int a, int b) { return a < b; };
+
+    // Pamiec to bufor pomocniczy, ktory sortowanie wzielo ze swiezej SortWorkspace; inne alokacje
+    // programu nie sa liczone, a sam pomiar nie spowalnia alokatora.
+    auto measure = [&](const char* name, int* baseArrays[], int arraySize, auto sortFunc) {
+        double totalTime = 0.0;
+        std::size_t peak = 0;
+        for (int i = 0; i < repeatCount; ++i) {
+            std::vector<int> arr(baseArrays[i], baseArrays[i] + arraySize);
+            SortWorkspace<int> workspace;
+
+            auto start = std::chrono::high_resolution_clock::now();
+            sortFunc(arr.data(), arraySize, workspace);
+            auto end = std::chrono::high_resolution_clock::now();
+            peak = std::max(peak, workspace.size() * sizeof(int));
+
+            totalTime += std::chrono::duration<double, std::milli>(end - start).count();
         }
+        std::cout << name << std::fixed << std::setprecision(2) << totalTime / repeatCount << " ms, "
+                  << std::setprecision(1) << peak / 1024.0 << " KB\n";
+    };
+
+    std::cout << "===== Sortowanie stabilne z mala pamiecia =====\n";
+    for (int arraySize : arraySizes) {
+        std::cout << "===== Rozmiar tablicy: " << arraySize << " =====\n";
 
-        double avgReverse = runSortExperiment(sortFunc, baseArrays, arraySize);
-        std::cout << "Odwrotne:         " << std::fixed << std::setprecision(2) << avgReverse << " ms\n";
+        int* baseArrays[repeatCount];
+        for (int i = 0; i < repeatCount; ++i)
+            baseArrays[i] = generateRandomArray(arraySize, i);
+
+        measure("mergeSort:                ", baseArrays, arraySize, [&](int* arr, int size, SortWorkspace<int>& workspace) {
+            mergeSort(arr, size, less, workspace);
+        });
+        measure("timSort:                  ", baseArrays, arraySize, [&](int* arr, int size, SortWorkspace<int>& workspace) {
+            timSort(arr, size, less, workspace);
+        });
+        measure("blockMergeSort (sqrt n):  ", baseArrays, arraySize, [&](int* arr, int size, SortWorkspace<int>& workspace) {
+            blockMergeSort(arr, size, less, workspace);
+        });
+        measure("blockMergeSort (512):     ", baseArrays, arraySize, [&](int* arr, int size, SortWorkspace<int>& workspace) {
+            blockMergeSort(arr, size, less, workspace.reserve(512));
+        });
+        measure("blockMergeSort (O(1)):    ", baseArrays, arraySize, [&](int* arr, int size, SortWorkspace<int>&) {
+            blockMergeSort(arr, size, less, ScratchSpan<int>{ nullptr, 0 });
+        });
 
         for (int i = 0; i < repeatCount; ++i)
             delete[] baseArrays[i];
+        std::cout << "\n";
+    }
+}
+
+// Czas sortowania bez instrumentacji i liczniki z drugiego przebiegu z CountingInstrumentation
+// na tych samych danych: porownania, przeniesienia, zamiany, glebokosc rekursji, niezrownowazenie
+// podzialow, przejscia na insertionSort i heapSort oraz zaalokowane bajty.
+void runInstrumentationExperiment() {
+    constexpr int arraySize = 1000000;
+    using Counting = CountingInstrumentation;
+    auto less = [](int a, int b) { return a < b; };
+    using Less = decltype(less);
+
+    auto report = [&](const char* name, const int* base, auto plainSort, auto countedSort) {
+        std::vector<int> arr(base, base + arraySize);
+        auto start = std::chrono::high_resolution_clock::now();
+        plainSort(arr.data(), arraySize);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        arr.assign(base, base + arraySize);
+        Counting::reset();
+        countedSort(arr.data(), arraySize);
+        const SortCounters& counters = Counting::counters();
+
+        std::cout << name << std::fixed << std::setprecision(2) << std::chrono::duration<double, std::milli>(end - start).count() << " ms"
+                  << "  porownania " << counters.comparisons << ", przeniesienia " << counters.moves << ", zamiany " << counters.swaps
+                  << ", glebokosc " << counters.maxDepth << ", podzialy " << counters.partitions
+                  << " (niezrownowazenie " << std::setprecision(3) << counters.imbalance() << ")"
+                  << ", insertionSort " << counters.insertionFallbacks << ", heapSort " << counters.heapFallbacks
+                  << ", bajty " << counters.bytesAllocated << "\n";
+        return counters;
+    };
+
+    // Zwraca liczniki introSort, zeby mozna bylo sprawdzic oczekiwania dla danego wejscia.
+    auto runAll = [&](const char* caseName, const int* base) {
+        std::cout << caseName << ":\n";
+        SortCounters introCounters = report("  introSort: ", base,
+               [&](int* arr, int size) { introSort(arr, size, less); },
+               [&](int* arr, int size) { introSort<int, Less, AdaptiveThreeWayPartition<BlockPartition>, AdaptivePivot, Counting>(arr, size, less); });
+        report("  quickSort: ", base,
+               [&](int* arr, int size) { quickSort(arr, size, less); },
+               [&](int* arr, int size) { quickSort<int, Less, AdaptiveThreeWayPartition<HoarePartition>, RandomPivot, Counting>(arr, size, less); });
+        report("  heapSort:  ", base,
+               [&](int* arr, int size) { heapSort(arr, size, less); },
+               [&](int* arr, int size) { heapSort<int, Less, heapSortArity, Counting>(arr, size, less); });
+        report("  mergeSort: ", base,
+               [&](int* arr, int size) { mergeSort(arr, size, less); },
+               [&](int* arr, int size) { mergeSort<int, Less, Counting>(arr, size, less); });
+        return introCounters;
+    };
+
+    std::cout << "===== Liczniki sortowan, " << arraySize << " elementow =====\n";
+
+    int* base = generateRandomArray(arraySize, 0);
+    runAll("Losowe", base);
+    delete[] base;
 
+    base = generatePartiallySortedArray(arraySize, 0.99, 0);
+    runAll("Posortowane w 99%", base);
+    delete[] base;
+
+    base = generateReverseSortedArray(arraySize);
+    SortCounters reversed = runAll("Odwrotne", base);
+    delete[] base;
+    // Odwrocone wejscie nie moze wyczerpywac limitu glebokosci domyslnego introSort.
+    if (reversed.heapFallbacks != 0) {
+        throw std::runtime_error("introSort na odwroconym wejsciu przeszedl na heapSort " + std::to_string(reversed.heapFallbacks) + " razy");
+    }
+
+    // Dwie serie rosnace (organy): mediana z trzech trafia w zle pivoty i introSort schodzi do heapSort.
+    std::vector<int> organPipe(arraySize);
+    for (int i = 0; i < arraySize / 2; ++i) {
+        organPipe[i] = i;
+        organPipe[arraySize - 1 - i] = i;
+    }
+    std::cout << "Organy (HoarePartition, MedianOf3Pivot):\n";
+    report("  introSort: ", organPipe.data(),
+           [&](int* arr, int size) { introSort<int, Less, HoarePartition, MedianOf3Pivot>(arr, size, less); },
+           [&](int* arr, int size) { introSort<int, Less, HoarePartition, MedianOf3Pivot, Counting>(arr, size, less); });
+    std::cout << "\n";
+}
+
+// Sortowanie wielu malych grup (np. list sasiedztwa) o stalym rozmiarze: insertionSort wobec
+// sieci staticSort wybieranej w czasie wykonania.
+void runSmallGroupExperiment() {
+    constexpr int groupSizes[] = { 4, 8, 16, 32 };
+    constexpr int arraySize = 4000000;
+    constexpr int repeatCount = 10;
+    auto less = [](int a, int b) { return a < b; };
+
+    int* baseArrays[repeatCount];
+    for (int i = 0; i < repeatCount; ++i)
+        baseArrays[i] = generateRandomArray(arraySize, i);
+
+    std::cout << "===== Male grupy, " << arraySize << " elementow =====\n";
+    for (int groupSize : groupSizes) {
+        auto insertion = [&](int* arr, int size) {
+            for (int i = 0; i + groupSize <= size; i += groupSize)
+                insertionSort(arr, i, i + groupSize - 1, less);
+        };
+        auto network = [&](int* arr, int size) {
+            for (int i = 0; i + groupSize <= size; i += groupSize)
+                staticSort(arr + i, groupSize, less);
+        };
+
+        std::cout << "Grupy po " << groupSize << ":\n";
+        std::cout << "  insertionSort: " << std::fixed << std::setprecision(2) << runSortExperiment(insertion, baseArrays, arraySize) << " ms\n";
+        std::cout << "  staticSort:    " << std::fixed << std::setprecision(2) << runSortExperiment(network, baseArrays, arraySize) << " ms\n";
+    }
+
+    for (int i = 0; i < repeatCount; ++i)
+        delete[] baseArrays[i];
+    std::cout << "\n";
+}
+
+// Sortowanie napisow: introSort<std::string> wobec multikeyQuickSort i burstSort.
+void runStringSortExperiment() {
+    constexpr int arraySizes[] = { 10000, 100000, 1000000 };
+    constexpr int repeatCount = 5;
+
+    auto measure = [&](const std::vector<std::string>* baseArrays, auto sortFunc) {
+        double totalTime = 0.0;
+        for (int i = 0; i < repeatCount; ++i) {
+            std::vector<std::string> arr = baseArrays[i];
+
+            auto start = std::chrono::high_resolution_clock::now();
+            sortFunc(arr.data(), arr.size());
+            auto end = std::chrono::high_resolution_clock::now();
+            totalTime += std::chrono::duration<double, std::milli>(end - start).count();
+        }
+        return totalTime / repeatCount;
+    };
+    auto intro = [](std::string* arr, std::size_t size) { introSort<std::string>(arr, size, std::less<std::string>{}); };
+    auto multikey = [](std::string* arr, std::size_t size) { multikeyQuickSort(arr, size); };
+    auto burst = [](std::string* arr, std::size_t size) { burstSort(arr, size); };
+
+    const std::pair<const char*, std::vector<std::string> (*)(int, int)> generators[] = {
+        { "Adresy URL", generateUrlArray },
+        { "Klucze logow", generateLogKeyArray },
+    };
+
+    std::cout << "===== Sortowanie napisow =====\n";
+    for (const auto& generator : generators) {
+        std::cout << "===== " << generator.first << " =====\n";
+        for (int arraySize : arraySizes) {
+            std::vector<std::string> baseArrays[repeatCount];
+            for (int i = 0; i < repeatCount; ++i)
+                baseArrays[i] = generator.second(arraySize, i);
+
+            std::cout << "Rozmiar " << arraySize << ":\n";
+            std::cout << "  introSort<std::string>: " << std::fixed << std::setprecision(2) << measure(baseArrays, intro) << " ms\n";
+            std::cout << "  multikeyQuickSort:      " << std::fixed << std::setprecision(2) << measure(baseArrays, multikey) << " ms\n";
+            std::cout << "  burstSort:              " << std::fixed << std::setprecision(2) << measure(baseArrays, burst) << " ms\n";
+        }
         std::cout << "\n";
     }
 }
 
-void mergeSortWrapper(int* arr, int size) {
-    mergeSort<int>(arr, size, [](int a, int b) { return a < b; });
+// Tryb narzedzia: extsort <wejscie> <wyjscie> [pamiec MB] [katalog tymczasowy]
+// sortuje plik binarny 32-bitowych liczb calkowitych sortowaniem zewnetrznym.
+int runExternalSortTool(int argc, char** argv) {
+    if (argc < 4) {
+        std::cerr << "Uzycie: " << argv[0] << " extsort <wejscie> <wyjscie> [pamiec MB] [katalog tymczasowy]\n";
+        return 1;
+    }
+
+    ExternalSortConfig config;
+    if (argc > 4) config.memoryBudget = static_cast<std::size_t>(std::stoull(argv[4])) << 20;
+    if (argc > 5) config.tempDirectory = argv[5];
+
+    auto start = std::chrono::high_resolution_clock::now();
+    externalSort<int>(argv[2], argv[3], config);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Posortowano w " << std::fixed << std::setprecision(2)
+              << std::chrono::duration<double>(end - start).count() << " s\n";
+    return 0;
 }
 
-void quickSortWrapper(int* arr, int size) {
-    quickSort<int>(arr, size, [](int a, int b) { return a < b; });
+// Tryb narzedzia: scaling [rozmiar] [maks. watki] mierzy czas parallelIntroSort na losowej
+// tablicy dla 1, 2, 4, ... watkow (domyslnie 10^8 elementow i do 64 watkow).
+int runScalingExperiment(int argc, char** argv) {
+    int arraySize = argc > 2 ? std::stoi(argv[2]) : 100000000;
+    unsigned maxThreads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 64;
+    constexpr int repeatCount = 3;
+
+    int* base = generateRandomArray(arraySize, 0);
+    std::cout << "===== Parallel Intro Sort: skalowanie, rozmiar " << arraySize << " =====\n";
+    double singleThread = 0.0;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        double totalTime = 0.0;
+        for (int i = 0; i < repeatCount; ++i) {
+            int* arr = nullptr;
+            try {
+                arr = copyArray(base, arraySize);
+                auto start = std::chrono::high_resolution_clock::now();
+                parallelIntroSort<int>(arr, arraySize, [](int a, int b) { return a < b; }, threads);
+                auto end = std::chrono::high_resolution_clock::now();
+                totalTime += std::chrono::duration<double, std::milli>(end - start).count();
+            }
+            catch (...) {
+                delete[] arr;
+                delete[] base;
+                throw;
+            }
+            delete[] arr;
+        }
+
+        double avg = totalTime / repeatCount;
+        if (threads == 1) singleThread = avg;
+        std::cout << "Watki " << std::setw(3) << threads << ":  " << std::fixed << std::setprecision(2) << avg
+                  << " ms  (przyspieszenie " << singleThread / avg << "x)\n";
+    }
+    delete[] base;
+    return 0;
 }
 
-void introSortWrapper(int* arr, int size) {
-    introSort<int>(arr, size, [](int a, int b) { return a < b; });
+// Tryb narzedzia: kmerge [serie] [dlugosc serii] [watki] scala posortowane serie (domyslnie 64
+// serie po 10^6 elementow) parami w log2(serie) przebiegach, jednym przebiegiem kWayMerge
+// oraz rownolegle parallelKWayMerge.
+int runKWayMergeExperiment(int argc, char** argv) {
+    std::size_t runCount = argc > 2 ? std::stoul(argv[2]) : 64;
+    std::size_t runLength = argc > 3 ? std::stoul(argv[3]) : 1000000;
+    unsigned threads = argc > 4 ? static_cast<unsigned>(std::stoul(argv[4])) : 0;
+    auto less = [](int a, int b) { return a < b; };
+
+    std::vector<int> runs(runCount * runLength);
+    for (std::size_t r = 0; r < runCount; ++r) {
+        int* run = generateRandomArray(static_cast<int>(runLength), static_cast<int>(r));
+        introSort<int>(run, runLength, less);
+        std::copy(run, run + runLength, runs.begin() + r * runLength);
+        delete[] run;
+    }
+    std::vector<std::pair<const int*, const int*>> inputs(runCount);
+    for (std::size_t r = 0; r < runCount; ++r) {
+        inputs[r] = { runs.data() + r * runLength, runs.data() + (r + 1) * runLength };
+    }
+    std::vector<int> out(runs.size());
+
+    auto measure = [](auto task) {
+        auto start = std::chrono::high_resolution_clock::now();
+        task();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    std::vector<int> source = runs;
+    double pairwise = measure([&] {
+        for (std::size_t width = runLength; width < source.size(); width *= 2) {
+            for (std::size_t left = 0; left < source.size(); left += 2 * width) {
+                std::size_t mid = std::min(left + width, source.size());
+                std::size_t right = std::min(left + 2 * width, source.size());
+                mergeRanges(source.data() + left, source.data() + mid, source.data() + mid, source.data() + right, out.data() + left, less);
+            }
+            source.swap(out);
+        }
+    });
+    double single = measure([&] { kWayMerge(inputs, out.data(), less); });
+    double parallel = measure([&] { parallelKWayMerge(inputs, out.data(), less, threads); });
+
+    std::cout << "===== Scalanie " << runCount << " serii po " << runLength << " elementow =====\n";
+    std::cout << "Parami (mergeRanges):  " << std::fixed << std::setprecision(2) << pairwise << " ms\n";
+    std::cout << "kWayMerge:             " << std::fixed << std::setprecision(2) << single << " ms\n";
+    std::cout << "parallelKWayMerge:     " << std::fixed << std::setprecision(2) << parallel << " ms\n";
+    return 0;
 }
 
-int main() {
+int main(int argc, char** argv) {
     try {
-        runExperimentForAllCases("Merge Sort", mergeSortWrapper);
-        runExperimentForAllCases("Quick Sort", quickSortWrapper);
-        runExperimentForAllCases("Intro Sort", introSortWrapper);
+        if (argc > 1 && std::string(argv[1]) == "extsort") {
+            return runExternalSortTool(argc, argv);
+        }
+        if (argc > 1 && std::string(argv[1]) == "scaling") {
+            return runScalingExperiment(argc, argv);
+        }
+        if (argc > 1 && std::string(argv[1]) == "kmerge") {
+            return runKWayMergeExperiment(argc, argv);
+        }
+        if (argc > 1 && std::string(argv[1]) == "bench") {
+            return runBenchmarkSuite(parseBenchmarkOptions(argc, argv, 2, defaultBenchmarkOptions()), benchmarkAlgorithms(), benchmarkDistributions());
+        }
+
+        runBenchmarkSuite(defaultBenchmarkOptions(), benchmarkAlgorithms(), benchmarkDistributions());
+        runSelectionExperiment();
+        runWideRecordExperiment();
+        runStringSortExperiment();
+        runSmallGroupExperiment();
+        runLowMemoryExperiment();
+        runInstrumentationExperiment();
     }
     catch (const std::bad_alloc& e) {
         std::cerr << "Błąd alokacji pamięci: " << e.what() << '\n';
@@ -1,34 +1,206 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <algorithm>
+#include <utility>
+#include <vector>
+#include "sortInstrumentation.hpp"
+
+// Domyslna arnosc kopca w heapSort: cztery dzieci to polowa poziomow kopca binarnego
+// przy niewiele wiekszej liczbie porownan na poziom.
+constexpr int heapSortArity = 4;
 
 template <typename E, typename Compare>
 void heapify(E* arr, std::size_t n, std::size_t i, const Compare& less) {
-    std::size_t largest = i;
-    std::size_t left = 2 * i + 1;
-    std::size_t right = 2 * i + 2;
+    while (true) {
+        std::size_t largest = i;
+        std::size_t left = 2 * i + 1;
+        std::size_t right = 2 * i + 2;
 
-    if (left < n&& less(arr[largest], arr[left])) {
-        largest = left;
+        if (left < n && less(arr[largest], arr[left])) {
+            largest = left;
+        }
+        if (right < n && less(arr[largest], arr[right])) {
+            largest = right;
+        }
+        if (largest == i) return;
+        std::swap(arr[i], arr[largest]);
+        i = largest;
     }
-    if (right < n&& less(arr[largest], arr[right])) {
-        largest = right;
+}
+
+// Jadra d-arnego kopca typu max w heap[0..size): dzieci wezla i to heap[Arity*i+1 .. Arity*i+Arity].
+// Gdy heap + 1 jest wyrownane do Arity * sizeof(E) bajtow, rodzenstwo lezy w jednej linii pamieci.
+
+// Dziura w `hole` jest przesuwana w gore, dopoki rodzic jest mniejszy od value (nie wyzej niz top).
+template <int Arity, typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+void heapSiftUp(E* heap, std::size_t hole, std::size_t top, E value, const Compare& less) {
+    while (hole > top) {
+        std::size_t parent = (hole - 1) / Arity;
+        if (!less(heap[parent], value)) break;
+        heap[hole] = std::move(heap[parent]);
+        Instrumentation::move();
+        hole = parent;
     }
-    if (largest != i) {
-        std::swap(arr[i], arr[largest]);
-        heapify(arr, n, largest, less);
+    heap[hole] = std::move(value);
+    Instrumentation::move();
+}
+
+// Sift-down Floyda: dziura schodzi do liscia zawsze za najwiekszym dzieckiem (Arity - 1 porownan
+// na poziom, bez porownywania z value), a dopiero potem value wraca w gore na swoje miejsce.
+// Przy zdejmowaniu maksimum value pochodzi z dna kopca, wiec powrot jest zwykle krotki.
+template <int Arity, typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+void heapSiftDown(E* heap, std::size_t size, std::size_t hole, E value, const Compare& less) {
+    static_assert(Arity >= 2, "kopiec musi miec co najmniej dwoje dzieci na wezel");
+    const std::size_t top = hole;
+
+    while (true) {
+        std::size_t first = Arity * hole + 1;
+        if (first >= size) break;
+
+        std::size_t best = first;
+        if (first + Arity <= size) {
+            // Wybor dziecka arytmetyka zamiast skoku - wynik porownania jest tu nieprzewidywalny.
+            for (std::size_t c = first + 1; c < first + Arity; ++c) {
+                best += static_cast<std::size_t>(less(heap[best], heap[c])) * (c - best);
+            }
+        }
+        else {
+            for (std::size_t c = first + 1; c < size; ++c) {
+                if (less(heap[best], heap[c])) best = c;
+            }
+        }
+        heap[hole] = std::move(heap[best]);
+        Instrumentation::move();
+        hole = best;
     }
+    heapSiftUp<Arity, Instrumentation>(heap, hole, top, std::move(value), less);
+}
+
+// Budowa kopca metoda Floyda od ostatniego wezla wewnetrznego do korzenia.
+template <int Arity, typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+void makeHeap(E* heap, std::size_t size, const Compare& less) {
+    if (size < 2) return;
+    for (std::size_t i = (size - 2) / Arity + 1; i > 0; --i) {
+        E value = std::move(heap[i - 1]);
+        Instrumentation::move();
+        heapSiftDown<Arity, Instrumentation>(heap, size, i - 1, std::move(value), less);
+    }
+}
+
+// Przenosi maksimum na heap[size - 1] i przywraca kopiec na heap[0..size-1).
+template <int Arity, typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+void popHeap(E* heap, std::size_t size, const Compare& less) {
+    if (size < 2) return;
+    E value = std::move(heap[size - 1]);
+    heap[size - 1] = std::move(heap[0]);
+    Instrumentation::move(2);
+    heapSiftDown<Arity, Instrumentation>(heap, size - 1, 0, std::move(value), less);
+}
+
+// Element heap[size - 1] dolacza do kopca heap[0..size-1).
+template <int Arity, typename E, typename Compare>
+void pushHeap(E* heap, std::size_t size, const Compare& less) {
+    if (size < 2) return;
+    E value = std::move(heap[size - 1]);
+    heapSiftUp<Arity>(heap, size - 1, 0, std::move(value), less);
+}
+
+// Ile pierwszych elementow pominac, zeby grupy rodzenstwa kopca zaczynajacego sie w arr + skip
+// byly wyrownane do Arity * sizeof(E) bajtow (0, gdy ten rozmiar nie jest potega dwojki).
+template <int Arity, typename E>
+std::size_t heapAlignmentSkip(const E* arr) {
+    constexpr std::size_t groupBytes = Arity * sizeof(E);
+    if ((groupBytes & (groupBytes - 1)) != 0 || groupBytes > 64) return 0;
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(arr + 1);
+    if (address % sizeof(E) != 0) return 0;
+    std::size_t misalignment = (address % groupBytes) / sizeof(E);
+    return misalignment == 0 ? 0 : Arity - misalignment;
 }
 
-template <typename E, typename Compare = std::less<E>>
+// Iteracyjny heapSort na d-arnym kopcu z sift-down Floyda. Poczatkowe (najwyzej Arity - 1)
+// elementy sa pomijane, zeby dzieci kazdego wezla lezaly w jednej linii pamieci; po posortowaniu
+// reszty sa one wstawiane na swoje miejsca.
+template <typename E, typename Compare = std::less<E>, int Arity = heapSortArity, typename Instrumentation = NoInstrumentation>
 void heapSort(E* arr, std::size_t size, const Compare& less = Compare{}) {
-    for (std::size_t i = size / 2; i > 0; --i) {
-        heapify(arr, size, i - 1, less);
+    if (size < 2) return;
+    if constexpr (needsCountingCompare<Instrumentation, Compare>) {
+        using Counting = CountingCompare<Compare, Instrumentation>;
+        heapSort<E, Counting, Arity, Instrumentation>(arr, size, Counting{ less });
+        return;
     }
 
-    for (std::size_t i = size - 1; i > 0; --i) {
-        std::swap(arr[0], arr[i]);
-        heapify(arr, i, 0, less);
+    std::size_t skip = heapAlignmentSkip<Arity>(arr);
+    if (skip >= size) skip = 0;
+
+    E* heap = arr + skip;
+    std::size_t heapSize = size - skip;
+    makeHeap<Arity, Instrumentation>(heap, heapSize, less);
+    for (std::size_t i = heapSize; i > 1; --i) {
+        popHeap<Arity, Instrumentation>(heap, i, less);
+    }
+
+    for (std::size_t i = skip; i > 0; --i) {
+        E value = std::move(arr[i - 1]);
+        std::size_t j = i - 1;
+        E* position = std::lower_bound(arr + i, arr + size, value, less);
+        std::move(arr + i, position, arr + j);
+        *(position - 1) = std::move(value);
+        Instrumentation::move(static_cast<std::size_t>(position - (arr + i)) + 2);
     }
 }
+
+// Kolejka priorytetowa (max wedlug less) na tych samych jadrach. Elementy trzymane sa
+// z przesunieciem w buforze tak, by grupy dzieci byly wyrownane jak w heapSort.
+template <typename E, typename Compare = std::less<E>, int Arity = heapSortArity>
+class Heap {
+    std::vector<E> storage;
+    std::size_t offset = 0;
+    std::size_t count = 0;
+    Compare less;
+
+    E* data() { return storage.data() + offset; }
+    const E* data() const { return storage.data() + offset; }
+
+    void grow(std::size_t capacity) {
+        std::vector<E> next(capacity + Arity);
+        std::size_t nextOffset = heapAlignmentSkip<Arity>(next.data());
+        std::move(data(), data() + count, next.data() + nextOffset);
+        storage.swap(next);
+        offset = nextOffset;
+    }
+
+public:
+    explicit Heap(const Compare& less = Compare{}) : less(less) {}
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    std::size_t capacity() const { return storage.empty() ? 0 : storage.size() - Arity; }
+
+    void reserve(std::size_t capacity) {
+        if (capacity > this->capacity()) grow(capacity);
+    }
+
+    void clear() { count = 0; }
+
+    const E& top() const { return data()[0]; }
+
+    void push(E value) {
+        if (count == capacity()) grow(std::max<std::size_t>(16, 2 * count));
+        heapSiftUp<Arity>(data(), count, 0, std::move(value), less);
+        ++count;
+    }
+
+    // Zdejmuje i zwraca maksimum.
+    E pop() {
+        popHeap<Arity>(data(), count, less);
+        --count;
+        return std::move(data()[count]);
+    }
+
+    // Zastepuje maksimum nowym elementem jednym sift-down (taniej niz pop + push).
+    void replaceTop(E value) {
+        heapSiftDown<Arity>(data(), count, 0, std::move(value), less);
+    }
+};
@@ -1,16 +1,25 @@
 #pragma once
 #include <cstddef>
 #include <functional>
+#include "sortInstrumentation.hpp"
 
-template <typename E, typename Compare>
+template <typename E, typename Compare, typename Instrumentation = NoInstrumentation>
 void insertionSort(E* arr, std::size_t left, std::size_t right, const Compare& less) {
+    if constexpr (needsCountingCompare<Instrumentation, Compare>) {
+        using Counting = CountingCompare<Compare, Instrumentation>;
+        insertionSort<E, Counting, Instrumentation>(arr, left, right, Counting{ less });
+        return;
+    }
+
     for (std::size_t i = left + 1; i <= right; ++i) {
         E key = arr[i];
         std::size_t j = i;
         while (j > left && less(key, arr[j - 1])) {
             arr[j] = arr[j - 1];
+            Instrumentation::move();
             --j;
         }
         arr[j] = key;
+        Instrumentation::move(2);
     }
 }
@@ -5,23 +5,79 @@
 #include "QuickSort.hpp"
 #include "HeapSort.hpp"
 #include "InsertionSort.hpp"
+#include "radixSort.hpp"
+#include "simdSort.hpp"
+#include "staticSort.hpp"
 
-template <typename E, typename Compare = std::less<E>>
-void introSort(E* arr, std::size_t size, const Compare& less = Compare{}) {
-    if (size < 2) return;
+constexpr std::size_t introSortThreshold = 16;
 
-    std::size_t depthLimit = 2 * static_cast<std::size_t>(std::log2(size));
-    const std::size_t sizeThreshold = 16;
+// Limit glebokosci liczony jest osobno dla kazdej sciezki rekurencji; po jego wyczerpaniu
+// dany podzakres konczy heapSort, a male podzakresy sortowanie przez wstawianie.
+// Rekurencja idzie w mniejsze podzakresy, najwiekszy jest obslugiwany w petli.
+template <typename Partition, typename Pivot, typename Instrumentation, typename E, typename Compare>
+void introSort_recursive(E* arr, int left, int right, const Compare& less, std::size_t depthLimit, std::size_t depth = 0) {
+    while (right - left + 1 > static_cast<int>(introSortThreshold)) {
+        Instrumentation::depth(depth);
+        if (depthLimit == 0) {
+            Instrumentation::heapFallback();
+            heapSort<E, Compare, heapSortArity, Instrumentation>(arr + left, static_cast<std::size_t>(right - left + 1), less);
+            return;
+        }
+        --depthLimit;
+        ++depth;
 
-    if (size <= sizeThreshold) {
-        insertionSort(arr, 0, size - 1, less);
-        return;
+        PartitionSegments parts = quickSortSegments<Partition, Pivot, Instrumentation>(arr, left, right, less);
+        recordPartition<Instrumentation>(parts, left, right);
+
+        int largest = 0;
+        for (int i = 1; i < parts.count; ++i) {
+            if (parts.right[i] - parts.left[i] > parts.right[largest] - parts.left[largest]) largest = i;
+        }
+        for (int i = 0; i < parts.count; ++i) {
+            if (i != largest) introSort_recursive<Partition, Pivot, Instrumentation>(arr, parts.left[i], parts.right[i], less, depthLimit, depth);
+        }
+        left = parts.left[largest];
+        right = parts.right[largest];
     }
 
-    quickSortStep(arr, 0, static_cast<int>(size) - 1, less, &depthLimit);
+    // Z instrumentacja male zakresy konczy zawsze insertionSort, zeby liczyc tez jego przeniesienia.
+    if (left < right) {
+        Instrumentation::insertionFallback();
+        if constexpr (Instrumentation::enabled) {
+            insertionSort<E, Compare, Instrumentation>(arr, left, right, less);
+        }
+        else {
+            smallSort(arr, left, right, less);
+        }
+    }
+}
 
-    
-    if (depthLimit == 0) {
-        heapSort(arr, size, less);
+// Domyslnie BlockPartition z wykrywaniem duplikatow, wiec wejscia z malo roznymi kluczami
+// nie wyczerpuja limitu glebokosci. Instrumentation (np. CountingInstrumentation) pokazuje,
+// czy sortowanie przeszlo na heapSort, jak gleboko zeszlo i jak nierowne byly podzialy.
+// Sortowanie jest zawsze w miejscu, rowniez dla kluczy calkowitych (americanFlagSort).
+template <typename E, typename Compare = std::less<E>, typename Partition = AdaptiveThreeWayPartition<BlockPartition>, typename Pivot = AdaptivePivot, typename Instrumentation = NoInstrumentation>
+void introSort(E* arr, std::size_t size, const Compare& less = Compare{}) {
+    if (size < 2) return;
+
+    if constexpr (needsCountingCompare<Instrumentation, Compare>) {
+        using Counting = CountingCompare<Compare, Instrumentation>;
+        introSort<E, Counting, Partition, Pivot, Instrumentation>(arr, size, Counting{ less });
+        return;
+    }
+    if constexpr (isStaticSortable<E> && !Instrumentation::enabled) {
+        if (size <= staticSortMaxSize) {
+            staticSort(arr, size, less);
+            return;
+        }
     }
+    if constexpr (isRadixDispatchable<E, Compare>) {
+        if (size >= radixSortThreshold) {
+            americanFlagSort(arr, size);
+            return;
+        }
+    }
+
+    std::size_t depthLimit = 2 * static_cast<std::size_t>(std::log2(size));
+    introSort_recursive<Partition, Pivot, Instrumentation>(arr, 0, static_cast<int>(size) - 1, less, depthLimit);
 }
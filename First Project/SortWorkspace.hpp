@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+// Bufor pomocniczy nalezacy do wywolujacego: sortowanie nie alokuje ani nie zwalnia pamieci.
+template <typename E>
+struct ScratchSpan {
+    E* data;
+    std::size_t size;
+};
+
+template <typename E>
+E* requireScratch(ScratchSpan<E> scratch, std::size_t needed, const char* sortName) {
+    if (scratch.size < needed || (needed > 0 && !scratch.data)) {
+        throw std::invalid_argument(std::string(sortName) + ": bufor pomocniczy ma " + std::to_string(scratch.size) +
+                                    " elementow, potrzeba " + std::to_string(needed));
+    }
+    return scratch.data;
+}
+
+// Pula pamieci pomocniczej wielokrotnego uzytku. Rosnie geometrycznie i nie maleje az do
+// release(), wiec w stanie ustalonym sortowania nie wywoluja alokatora.
+template <typename E>
+class SortWorkspace {
+    std::unique_ptr<E[]> storage;
+    std::size_t capacity = 0;
+
+public:
+    // Osobna pula dla kazdego watku, nie wymaga synchronizacji.
+    static SortWorkspace& local() {
+        thread_local SortWorkspace workspace;
+        return workspace;
+    }
+
+    ScratchSpan<E> reserve(std::size_t needed) {
+        if (needed > capacity) {
+            std::size_t grown = capacity * 2 > needed ? capacity * 2 : needed;
+            E* fresh = new (std::nothrow) E[grown];
+            if (!fresh) {
+                throw std::bad_alloc();
+            }
+            storage.reset(fresh);
+            capacity = grown;
+        }
+        return { storage.get(), capacity };
+    }
+
+    std::size_t size() const { return capacity; }
+
+    void release() {
+        storage.reset();
+        capacity = 0;
+    }
+};
@@ -0,0 +1,396 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "datasets.hpp"
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Liczniki sprzetowe jednego pomiaru; -1 oznacza licznik niedostepny (brak perf_event_open,
+// maszyna wirtualna bez PMU albo zbyt restrykcyjne perf_event_paranoid).
+struct HardwareCounters {
+    long long cycles = -1;
+    long long instructions = -1;
+    long long branchMisses = -1;
+    long long cacheMisses = -1;
+};
+
+// Cztery liczniki perf_event_open dla biezacego watku i watkow przez niego tworzonych (inherit),
+// tylko przestrzen uzytkownika. Watki sortowan rownoleglych powstaja po start() i koncza sie
+// przed stop(), wiec ich zdarzenia sa doliczane do wyniku. Kazdy licznik otwierany jest osobno,
+// wiec brak jednego (np. chybien LLC) nie wylacza pozostalych.
+class PerfCounters {
+#if defined(__linux__)
+    static constexpr int eventCount = 4;
+    int fds[eventCount] = { -1, -1, -1, -1 };
+
+    static int openEvent(std::uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    long long value(int index) const {
+        long long count = 0;
+        if (fds[index] < 0 || read(fds[index], &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) return -1;
+        return count;
+    }
+
+public:
+    PerfCounters() {
+        const std::uint64_t configs[eventCount] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                    PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES };
+        for (int i = 0; i < eventCount; ++i) fds[i] = openEvent(configs[i]);
+    }
+
+    ~PerfCounters() {
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const {
+        return std::any_of(std::begin(fds), std::end(fds), [](int fd) { return fd >= 0; });
+    }
+
+    void start() {
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    HardwareCounters stop() {
+        for (int fd : fds) {
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        HardwareCounters result;
+        result.cycles = value(0);
+        result.instructions = value(1);
+        result.branchMisses = value(2);
+        result.cacheMisses = value(3);
+        return result;
+    }
+#else
+public:
+    bool available() const { return false; }
+    void start() {}
+    HardwareCounters stop() { return {}; }
+#endif
+};
+
+struct BenchmarkStats {
+    double minMs = 0.0;
+    double medianMs = 0.0;
+    double p95Ms = 0.0;
+    double nsPerElement = 0.0;
+};
+
+// Mediana (srednia dwoch srodkowych przy parzystej liczbie probek) i p95 metoda najblizszej rangi.
+inline BenchmarkStats computeBenchmarkStats(std::vector<double> samples, std::size_t size) {
+    BenchmarkStats stats;
+    if (samples.empty()) return stats;
+    std::sort(samples.begin(), samples.end());
+
+    std::size_t n = samples.size();
+    stats.minMs = samples.front();
+    stats.medianMs = n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+    std::size_t rank = (95 * n + 99) / 100;
+    stats.p95Ms = samples[std::max<std::size_t>(rank, 1) - 1];
+    stats.nsPerElement = size > 0 ? stats.medianMs * 1e6 / static_cast<double>(size) : 0.0;
+    return stats;
+}
+
+inline long long medianCounter(std::vector<long long> values) {
+    values.erase(std::remove(values.begin(), values.end(), -1LL), values.end());
+    if (values.empty()) return -1;
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+struct BenchmarkResult {
+    std::string algorithm;
+    std::string distribution;
+    std::size_t size = 0;
+    int repeats = 0;
+    BenchmarkStats stats;
+    HardwareCounters counters;
+};
+
+struct BenchmarkOptions {
+    std::vector<std::string> algorithms;     // puste = wszystkie zarejestrowane
+    std::vector<std::string> distributions;  // puste = wszystkie zarejestrowane
+    std::vector<std::size_t> sizes;
+    int repeats = 10;
+    int warmup = 2;
+    std::string format = "text";  // text, csv albo json
+    std::string output;           // puste = standardowe wyjscie
+    std::string baseline;         // plik CSV z wczesniejszego przebiegu
+    double threshold = 0.05;      // wzrost mediany uznawany za regresje
+    std::string cacheDirectory = "datasets";  // katalog zbiorow danych, puste = bez zapisu
+};
+
+inline std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// Opcje w postaci --nazwa wartosc od argv[first]:
+// --algorithms a,b  --distributions d,e  --sizes 1000,1000000  --repeats N  --warmup N
+// --format text|csv|json  --output plik  --baseline plik.csv  --threshold 0.05  --cache-dir katalog
+inline BenchmarkOptions parseBenchmarkOptions(int argc, char** argv, int first, BenchmarkOptions options = {}) {
+    for (int i = first; i < argc; ++i) {
+        std::string name = argv[i];
+        if (i + 1 >= argc) throw std::invalid_argument("brak wartosci opcji " + name);
+        std::string value = argv[++i];
+
+        if (name == "--algorithms") options.algorithms = splitList(value);
+        else if (name == "--distributions") options.distributions = splitList(value);
+        else if (name == "--sizes") {
+            options.sizes.clear();
+            for (const std::string& size : splitList(value)) options.sizes.push_back(static_cast<std::size_t>(std::stoull(size)));
+        }
+        else if (name == "--repeats") options.repeats = std::stoi(value);
+        else if (name == "--warmup") options.warmup = std::stoi(value);
+        else if (name == "--format") options.format = value;
+        else if (name == "--output") options.output = value;
+        else if (name == "--baseline") options.baseline = value;
+        else if (name == "--threshold") options.threshold = std::stod(value);
+        else if (name == "--cache-dir") options.cacheDirectory = value;
+        else throw std::invalid_argument("nieznana opcja " + name);
+    }
+
+    if (options.repeats < 1) throw std::invalid_argument("--repeats musi byc dodatnie");
+    if (options.warmup < 0) throw std::invalid_argument("--warmup nie moze byc ujemne");
+    if (options.format != "text" && options.format != "csv" && options.format != "json") {
+        throw std::invalid_argument("nieznany format " + options.format);
+    }
+    return options;
+}
+
+using BenchmarkSort = std::function<void(int*, std::size_t)>;
+using BenchmarkInput = std::function<Dataset(std::size_t size, unsigned seed, const std::string& cacheDirectory)>;
+
+template <typename Entry>
+std::vector<Entry> selectBenchmarkEntries(const std::vector<Entry>& registered, const std::vector<std::string>& names, const char* kind) {
+    if (names.empty()) return registered;
+    std::vector<Entry> selected;
+    for (const std::string& name : names) {
+        auto found = std::find_if(registered.begin(), registered.end(), [&](const Entry& entry) { return entry.first == name; });
+        if (found == registered.end()) throw std::invalid_argument(std::string("nieznany ") + kind + ": " + name);
+        selected.push_back(*found);
+    }
+    return selected;
+}
+
+// Dla kazdego rozkladu i rozmiaru wczytuje albo generuje `repeats` tablic (ziarna 0..repeats-1) raz dla
+// wszystkich algorytmow. Kazdy algorytm najpierw sortuje `warmup` kopii pierwszej tablicy bez
+// pomiaru, potem kazda tablice raz; czas i liczniki obejmuja samo sortowanie, bez kopiowania.
+inline std::vector<BenchmarkResult> runBenchmarks(const BenchmarkOptions& options,
+                                                  const std::vector<std::pair<std::string, BenchmarkSort>>& algorithms,
+                                                  const std::vector<std::pair<std::string, BenchmarkInput>>& distributions) {
+    auto selectedAlgorithms = selectBenchmarkEntries(algorithms, options.algorithms, "algorytm");
+    auto selectedDistributions = selectBenchmarkEntries(distributions, options.distributions, "rozklad");
+
+    PerfCounters perf;
+    std::vector<BenchmarkResult> results;
+    std::vector<int> arr;
+
+    for (const auto& distribution : selectedDistributions) {
+        for (std::size_t size : options.sizes) {
+            std::vector<Dataset> inputs;
+            for (int seed = 0; seed < options.repeats; ++seed) {
+                inputs.push_back(distribution.second(size, static_cast<unsigned>(seed), options.cacheDirectory));
+            }
+
+            for (const auto& algorithm : selectedAlgorithms) {
+                for (int i = 0; i < options.warmup; ++i) {
+                    arr.assign(inputs[0].begin(), inputs[0].end());
+                    algorithm.second(arr.data(), size);
+                }
+
+                std::vector<double> samples;
+                std::vector<long long> cycles, instructions, branchMisses, cacheMisses;
+                for (const Dataset& input : inputs) {
+                    arr.assign(input.begin(), input.end());
+                    perf.start();
+                    auto start = std::chrono::steady_clock::now();
+                    algorithm.second(arr.data(), size);
+                    auto end = std::chrono::steady_clock::now();
+                    HardwareCounters counters = perf.stop();
+
+                    if (!std::is_sorted(arr.begin(), arr.end())) {
+                        throw std::runtime_error(algorithm.first + " nie posortowal danych " + distribution.first);
+                    }
+                    samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+                    cycles.push_back(counters.cycles);
+                    instructions.push_back(counters.instructions);
+                    branchMisses.push_back(counters.branchMisses);
+                    cacheMisses.push_back(counters.cacheMisses);
+                }
+
+                BenchmarkResult result;
+                result.algorithm = algorithm.first;
+                result.distribution = distribution.first;
+                result.size = size;
+                result.repeats = options.repeats;
+                result.stats = computeBenchmarkStats(samples, size);
+                result.counters.cycles = medianCounter(cycles);
+                result.counters.instructions = medianCounter(instructions);
+                result.counters.branchMisses = medianCounter(branchMisses);
+                result.counters.cacheMisses = medianCounter(cacheMisses);
+                results.push_back(result);
+            }
+        }
+    }
+    return results;
+}
+
+inline std::string counterText(long long value, const char* missing) {
+    return value < 0 ? std::string(missing) : std::to_string(value);
+}
+
+inline void writeBenchmarkText(const std::vector<BenchmarkResult>& results, std::ostream& out) {
+    out << std::left << std::setw(22) << "algorytm" << std::setw(14) << "rozklad" << std::right << std::setw(11) << "rozmiar"
+        << std::setw(11) << "min ms" << std::setw(11) << "mediana ms" << std::setw(11) << "p95 ms" << std::setw(10) << "ns/elem"
+        << std::setw(15) << "cykle" << std::setw(15) << "instrukcje" << std::setw(15) << "bledy skokow" << std::setw(15) << "chybienia LLC" << "\n";
+    for (const BenchmarkResult& r : results) {
+        out << std::left << std::setw(22) << r.algorithm << std::setw(14) << r.distribution << std::right << std::setw(11) << r.size
+            << std::fixed << std::setprecision(3) << std::setw(11) << r.stats.minMs << std::setw(11) << r.stats.medianMs
+            << std::setw(11) << r.stats.p95Ms << std::setprecision(2) << std::setw(10) << r.stats.nsPerElement
+            << std::setw(15) << counterText(r.counters.cycles, "-") << std::setw(15) << counterText(r.counters.instructions, "-")
+            << std::setw(15) << counterText(r.counters.branchMisses, "-") << std::setw(15) << counterText(r.counters.cacheMisses, "-") << "\n";
+    }
+}
+
+inline void writeBenchmarkCsv(const std::vector<BenchmarkResult>& results, std::ostream& out) {
+    out << "algorithm,distribution,size,repeats,min_ms,median_ms,p95_ms,ns_per_element,cycles,instructions,branch_misses,llc_misses\n";
+    out << std::setprecision(6) << std::fixed;
+    for (const BenchmarkResult& r : results) {
+        out << r.algorithm << ',' << r.distribution << ',' << r.size << ',' << r.repeats << ',' << r.stats.minMs << ','
+            << r.stats.medianMs << ',' << r.stats.p95Ms << ',' << r.stats.nsPerElement << ','
+            << counterText(r.counters.cycles, "") << ',' << counterText(r.counters.instructions, "") << ','
+            << counterText(r.counters.branchMisses, "") << ',' << counterText(r.counters.cacheMisses, "") << "\n";
+    }
+}
+
+inline void writeBenchmarkJson(const std::vector<BenchmarkResult>& results, std::ostream& out) {
+    out << "[\n" << std::setprecision(6) << std::fixed;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        out << "  {\"algorithm\": \"" << r.algorithm << "\", \"distribution\": \"" << r.distribution << "\", \"size\": " << r.size
+            << ", \"repeats\": " << r.repeats << ", \"min_ms\": " << r.stats.minMs << ", \"median_ms\": " << r.stats.medianMs
+            << ", \"p95_ms\": " << r.stats.p95Ms << ", \"ns_per_element\": " << r.stats.nsPerElement
+            << ", \"cycles\": " << counterText(r.counters.cycles, "null") << ", \"instructions\": " << counterText(r.counters.instructions, "null")
+            << ", \"branch_misses\": " << counterText(r.counters.branchMisses, "null")
+            << ", \"llc_misses\": " << counterText(r.counters.cacheMisses, "null") << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+// Odczyt pliku zapisanego przez writeBenchmarkCsv (liczniki nie sa potrzebne do porownania).
+inline std::vector<BenchmarkResult> readBenchmarkCsv(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("nie mozna otworzyc pliku " + path);
+
+    std::vector<BenchmarkResult> results;
+    std::string line;
+    std::getline(in, line);
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, ',')) fields.push_back(field);
+        if (fields.size() < 8) continue;
+
+        BenchmarkResult r;
+        r.algorithm = fields[0];
+        r.distribution = fields[1];
+        r.size = static_cast<std::size_t>(std::stoull(fields[2]));
+        r.repeats = std::stoi(fields[3]);
+        r.stats.minMs = std::stod(fields[4]);
+        r.stats.medianMs = std::stod(fields[5]);
+        r.stats.p95Ms = std::stod(fields[6]);
+        r.stats.nsPerElement = std::stod(fields[7]);
+        results.push_back(r);
+    }
+    return results;
+}
+
+// Porownanie median z baseline dla wspolnych (algorytm, rozklad, rozmiar); zwraca liczbe regresji,
+// czyli wzrostow mediany o wiecej niz threshold.
+inline int compareWithBaseline(const std::vector<BenchmarkResult>& results, const std::vector<BenchmarkResult>& baseline, double threshold, std::ostream& out) {
+    int regressions = 0;
+    for (const BenchmarkResult& r : results) {
+        auto found = std::find_if(baseline.begin(), baseline.end(), [&](const BenchmarkResult& b) {
+            return b.algorithm == r.algorithm && b.distribution == r.distribution && b.size == r.size;
+        });
+        if (found == baseline.end() || found->stats.medianMs <= 0.0) continue;
+
+        double change = r.stats.medianMs / found->stats.medianMs - 1.0;
+        bool regression = change > threshold;
+        regressions += regression;
+        out << std::left << std::setw(22) << r.algorithm << std::setw(14) << r.distribution << std::right << std::setw(11) << r.size
+            << std::fixed << std::setprecision(3) << std::setw(11) << found->stats.medianMs << " -> " << std::setw(11) << r.stats.medianMs
+            << " ms  " << std::showpos << std::setprecision(1) << change * 100.0 << std::noshowpos << "%" << (regression ? "  REGRESJA" : "") << "\n";
+    }
+    return regressions;
+}
+
+// Pelny przebieg: pomiary, zapis w wybranym formacie, opcjonalne porownanie z baseline.
+// Zwraca kod wyjscia: 0, albo 2 gdy porownanie wykazalo regresje.
+inline int runBenchmarkSuite(const BenchmarkOptions& options,
+                             const std::vector<std::pair<std::string, BenchmarkSort>>& algorithms,
+                             const std::vector<std::pair<std::string, BenchmarkInput>>& distributions) {
+    if (!PerfCounters().available()) {
+        std::cerr << "perf_event_open niedostepne - liczniki sprzetowe nie beda zbierane\n";
+    }
+    std::vector<BenchmarkResult> results = runBenchmarks(options, algorithms, distributions);
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) throw std::runtime_error("nie mozna zapisac pliku " + options.output);
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+    if (options.format == "csv") writeBenchmarkCsv(results, out);
+    else if (options.format == "json") writeBenchmarkJson(results, out);
+    else writeBenchmarkText(results, out);
+
+    if (options.baseline.empty()) return 0;
+    std::cout << "===== Porownanie z " << options.baseline << " (prog " << options.threshold * 100.0 << "%) =====\n";
+    int regressions = compareWithBaseline(results, readBenchmarkCsv(options.baseline), options.threshold, std::cout);
+    std::cout << "Regresje: " << regressions << "\n";
+    return regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// Plik binarny zamykany w destruktorze.
+class BinaryFile {
+    std::FILE* file = nullptr;
+    std::string path;
+
+public:
+    BinaryFile(const std::string& path, const char* mode) : path(path) {
+        file = std::fopen(path.c_str(), mode);
+        if (!file) {
+            throw std::runtime_error("Nie mozna otworzyc pliku: " + path);
+        }
+    }
+    BinaryFile(BinaryFile&& other) noexcept : file(other.file), path(std::move(other.path)) {
+        other.file = nullptr;
+    }
+    BinaryFile(const BinaryFile&) = delete;
+    BinaryFile& operator=(const BinaryFile&) = delete;
+    ~BinaryFile() {
+        if (file) std::fclose(file);
+    }
+
+    template <typename E>
+    std::size_t read(E* data, std::size_t count) {
+        std::size_t got = std::fread(data, sizeof(E), count, file);
+        if (got < count && std::ferror(file)) {
+            throw std::runtime_error("Blad odczytu pliku: " + path);
+        }
+        return got;
+    }
+
+    template <typename E>
+    void write(const E* data, std::size_t count) {
+        if (std::fwrite(data, sizeof(E), count, file) != count) {
+            throw std::runtime_error("Blad zapisu pliku: " + path);
+        }
+    }
+
+    void close() {
+        if (file && std::fclose(file) != 0) {
+            file = nullptr;
+            throw std::runtime_error("Blad zamkniecia pliku: " + path);
+        }
+        file = nullptr;
+    }
+};
@@ -0,0 +1,240 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <functional>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include "SortWorkspace.hpp"
+#include "simdSort.hpp"
+
+// Dlugosc serii sortowanych wstepnie przez wstawianie w blockMergeSort.
+constexpr std::size_t blockMergeSortRun = 16;
+
+// Najwieksza liczba blokow A w jednym scaleniu blokowym. Numery blokow trzymane sa w tablicy
+// na stosie, wiec dla serii dluzszych niz blockMergeMaxBlocks^2 blok rosnie ponad sqrt(n).
+constexpr std::size_t blockMergeMaxBlocks = 256;
+
+// Bufor, przy ktorym wszystkie lokalne scalenia blockMergeSort sa liniowe: sqrt(size) elementow.
+inline std::size_t blockMergeSortBufferSize(std::size_t size) {
+    std::size_t root = static_cast<std::size_t>(std::sqrt(static_cast<double>(size)));
+    while (root * root < size) ++root;
+    return root;
+}
+
+// Scalanie arr[lo..mid) i arr[mid..hi), gdy lewa seria miesci sie w buforze.
+template <typename E, typename Compare>
+void blockMergeForward(E* arr, std::size_t lo, std::size_t mid, std::size_t hi, E* cache, const Compare& less) {
+    std::move(arr + lo, arr + mid, cache);
+    E* a = cache;
+    E* aEnd = cache + (mid - lo);
+    std::size_t b = mid;
+    std::size_t out = lo;
+
+    while (a != aEnd && b < hi) {
+        if (less(arr[b], *a)) arr[out++] = std::move(arr[b++]);
+        else arr[out++] = std::move(*a++);
+    }
+    std::move(a, aEnd, arr + out);
+}
+
+// Scalanie od konca, gdy w buforze miesci sie prawa seria.
+template <typename E, typename Compare>
+void blockMergeBackward(E* arr, std::size_t lo, std::size_t mid, std::size_t hi, E* cache, const Compare& less) {
+    std::move(arr + mid, arr + hi, cache);
+    E* b = cache + (hi - mid);
+    std::size_t a = mid;
+    std::size_t out = hi;
+
+    while (b != cache && a > lo) {
+        if (less(*(b - 1), arr[a - 1])) arr[--out] = std::move(arr[--a]);
+        else arr[--out] = std::move(*--b);
+    }
+    std::move(cache, b, arr + lo);
+}
+
+// Stabilne scalanie w miejscu: dluzsza seria jest dzielona w polowie, jej element srodkowy
+// wyszukiwany binarnie w drugiej, a rotacja zamienia srodkowe fragmenty. Podzial konczy sie,
+// gdy krotsza seria miesci sie w buforze (cacheSize moze byc 0). Stos O(log n).
+template <typename E, typename Compare>
+void blockMergeInPlace(E* arr, std::size_t lo, std::size_t mid, std::size_t hi, E* cache, std::size_t cacheSize, const Compare& less) {
+    while (lo < mid && mid < hi) {
+        if (!less(arr[mid], arr[mid - 1])) return;
+
+        std::size_t leftSize = mid - lo;
+        std::size_t rightSize = hi - mid;
+        if (leftSize <= cacheSize) {
+            blockMergeForward(arr, lo, mid, hi, cache, less);
+            return;
+        }
+        if (rightSize <= cacheSize) {
+            blockMergeBackward(arr, lo, mid, hi, cache, less);
+            return;
+        }
+
+        std::size_t cutLeft, cutRight;
+        if (leftSize >= rightSize) {
+            cutLeft = lo + leftSize / 2;
+            cutRight = std::lower_bound(arr + mid, arr + hi, arr[cutLeft], less) - arr;
+        }
+        else {
+            cutRight = mid + rightSize / 2;
+            cutLeft = std::upper_bound(arr + lo, arr + mid, arr[cutRight], less) - arr;
+        }
+        std::rotate(arr + cutLeft, arr + mid, arr + cutRight);
+        std::size_t newMid = cutLeft + (cutRight - mid);
+
+        // Mniejsza polowa rekurencyjnie, wieksza w petli.
+        if (newMid - lo < hi - newMid) {
+            blockMergeInPlace(arr, lo, cutLeft, newMid, cache, cacheSize, less);
+            lo = newMid;
+            mid = cutRight;
+        }
+        else {
+            blockMergeInPlace(arr, newMid, cutRight, hi, cache, cacheSize, less);
+            hi = newMid;
+            mid = cutLeft;
+        }
+    }
+}
+
+// Scalanie blokowe jak w WikiSort: lewa seria A dzielona jest na bloki dlugosci ~sqrt(|A|),
+// ktore "tocza sie" przez prawa serie B (zamiana z kolejnymi blokami B). Blok A o najmniejszych
+// kluczach zostaje na miejscu, gdy ostatni element poprzedniego bloku B nie jest od niego mniejszy,
+// i jest scalany lokalnie z wartosciami B, ktore trafily za poprzedni upuszczony blok.
+// Kolejnosc blokow A (potrzebna do stabilnosci przy rownych kluczach) pamietaja ich numery
+// zamiast znacznikow z unikalnych kluczy. Lokalne scalenia uzywaja bufora, jesli jest dosc duzy.
+template <typename E, typename Compare>
+void blockMerge(E* arr, std::size_t lo, std::size_t mid, std::size_t hi, E* cache, std::size_t cacheSize, const Compare& less) {
+    if (lo == mid || mid == hi || !less(arr[mid], arr[mid - 1])) return;
+    if (less(arr[hi - 1], arr[lo])) {
+        std::rotate(arr + lo, arr + mid, arr + hi);
+        return;
+    }
+
+    std::size_t leftSize = mid - lo;
+    std::size_t blockSize = std::max(blockMergeSortBufferSize(leftSize), (leftSize + blockMergeMaxBlocks - 1) / blockMergeMaxBlocks);
+    std::size_t blockCount = leftSize / blockSize;
+    if (leftSize <= cacheSize || hi - mid <= cacheSize || blockCount < 2) {
+        blockMergeInPlace(arr, lo, mid, hi, cache, cacheSize, less);
+        return;
+    }
+
+    // Numery blokow A w kolejnosci ich polozenia, jako bufor cykliczny od front.
+    std::uint16_t ids[blockMergeMaxBlocks];
+    for (std::size_t i = 0; i < blockCount; ++i) ids[i] = static_cast<std::uint16_t>(i);
+    std::size_t front = 0;
+    std::size_t remaining = blockCount;
+
+    // Niepelny pierwszy blok A od razu jest "upuszczony" na swoim miejscu.
+    std::size_t lastAStart = lo;
+    std::size_t lastAEnd = lo + leftSize % blockSize;
+    std::size_t aStart = lastAEnd;
+    std::size_t aEnd = mid;
+    std::size_t lastBStart = aStart;
+    std::size_t lastBEnd = aStart;
+    std::size_t bStart = mid;
+    std::size_t bEnd = mid + std::min(blockSize, hi - mid);
+
+    while (true) {
+        std::size_t minIndex = 0;
+        for (std::size_t i = 1; i < remaining; ++i) {
+            if (ids[(front + i) % blockCount] < ids[(front + minIndex) % blockCount]) minIndex = i;
+        }
+        std::size_t minStart = aStart + minIndex * blockSize;
+
+        if ((lastBEnd > lastBStart && !less(arr[lastBEnd - 1], arr[minStart])) || bStart == bEnd) {
+            // Czesc poprzedniego bloku B nie mniejsza od bloku A przechodzi za niego.
+            std::size_t split = std::lower_bound(arr + lastBStart, arr + lastBEnd, arr[minStart], less) - arr;
+            std::size_t bRemaining = lastBEnd - split;
+
+            if (minIndex != 0) {
+                std::swap_ranges(arr + aStart, arr + aStart + blockSize, arr + minStart);
+                std::swap(ids[front], ids[(front + minIndex) % blockCount]);
+            }
+            blockMergeInPlace(arr, lastAStart, lastAEnd, split, cache, cacheSize, less);
+            std::rotate(arr + split, arr + aStart, arr + aStart + blockSize);
+
+            lastAStart = aStart - bRemaining;
+            lastAEnd = lastAStart + blockSize;
+            lastBStart = lastAEnd;
+            lastBEnd = lastAEnd + bRemaining;
+            aStart += blockSize;
+            front = (front + 1) % blockCount;
+            if (--remaining == 0) break;
+        }
+        else if (bEnd - bStart < blockSize) {
+            // Ostatni, niepelny blok B przechodzi przed wszystkie bloki A.
+            std::size_t length = bEnd - bStart;
+            std::rotate(arr + aStart, arr + bStart, arr + bEnd);
+            lastBStart = aStart;
+            lastBEnd = aStart + length;
+            aStart += length;
+            aEnd += length;
+            bStart = bEnd;
+        }
+        else {
+            // Pierwszy blok A zamienia sie miejscem z kolejnym blokiem B i staje sie ostatnim.
+            std::swap_ranges(arr + aStart, arr + aStart + blockSize, arr + bStart);
+            lastBStart = aStart;
+            lastBEnd = aStart + blockSize;
+            aStart += blockSize;
+            aEnd += blockSize;
+            ids[(front + remaining) % blockCount] = ids[front];
+            front = (front + 1) % blockCount;
+            bStart += blockSize;
+            bEnd = std::min(bEnd + blockSize, hi);
+        }
+    }
+
+    blockMergeInPlace(arr, lastAStart, lastAEnd, hi, cache, cacheSize, less);
+}
+
+// Stabilne sortowanie przez scalanie blokowe z buforem dowolnej wielkosci, rowniez pustym
+// (wtedy pamiec dodatkowa to O(1) poza stosem O(log n)). Od blockMergeSortBufferSize(size)
+// elementow scalenia sa liniowe; mniejszy bufor przyspiesza tylko czesc lokalnych scalen.
+template <typename E, typename Compare>
+void blockMergeSort(E* arr, std::size_t size, const Compare& less, ScratchSpan<E> scratch) {
+    if (size < 2) return;
+    E* cache = scratch.data;
+    std::size_t cacheSize = cache ? scratch.size : 0;
+
+    for (std::size_t lo = 0; lo < size; lo += blockMergeSortRun) {
+        std::size_t hi = std::min(lo + blockMergeSortRun, size);
+        stableSmallSort(arr, lo, hi - 1, less);
+    }
+
+    for (std::size_t width = blockMergeSortRun; width < size; width *= 2) {
+        for (std::size_t lo = 0; lo + width < size; lo += 2 * width) {
+            blockMerge(arr, lo, lo + width, std::min(lo + 2 * width, size), cache, cacheSize, less);
+        }
+    }
+}
+
+// Wersja przydzielajaca bufor sqrt(size) elementow. Gdy przydzial sie nie uda, sortuje bez bufora.
+template <typename E, typename Compare = std::less<E>>
+void blockMergeSort(E* arr, std::size_t size, const Compare& less = Compare{}) {
+    if (size < 2) return;
+
+    std::size_t cacheSize = blockMergeSortBufferSize(size);
+    E* cache = new (std::nothrow) E[cacheSize];
+    if (!cache) {
+        cacheSize = 0;
+    }
+
+    try {
+        blockMergeSort(arr, size, less, ScratchSpan<E>{ cache, cacheSize });
+    }
+    catch (...) {
+        delete[] cache;
+        throw;
+    }
+
+    delete[] cache;
+}
+
+template <typename E, typename Compare>
+void blockMergeSort(E* arr, std::size_t size, const Compare& less, SortWorkspace<E>& workspace) {
+    blockMergeSort(arr, size, less, workspace.reserve(blockMergeSortBufferSize(size)));
+}
@@ -0,0 +1,319 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "parallelTasks.hpp"
+#include "binaryFile.hpp"
+// DATASET_MMAP=0 wymusza zwykle wczytywanie plikow takze na systemach z mmap.
+#ifndef DATASET_MMAP
+#if defined(__unix__) || defined(__APPLE__)
+#define DATASET_MMAP 1
+#else
+#define DATASET_MMAP 0
+#endif
+#endif
+#if DATASET_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Zbiory mniejsze niz ten prog (262 144 elementy) generuja sie szybciej, niz wczytuja z dysku,
+// wiec nie sa zapisywane. Z domyslnych rozmiarow bench zapisywane sa 500 000 i 1 000 000.
+constexpr std::size_t datasetCacheMinSize = std::size_t(1) << 18;
+
+// Ponizej tej liczby elementow na watek generowanie jest sekwencyjne.
+constexpr std::size_t datasetParallelMinSlice = std::size_t(1) << 18;
+
+// Philox4x32-10 (Salmon i in., "Parallel random numbers: as easy as 1, 2, 3"): licznik i klucz
+// daja cztery 32-bitowe slowa bez stanu, wiec element i zalezy tylko od (ziarno, i) i dowolny
+// podzial na watki daje te same dane.
+inline std::array<std::uint32_t, 4> philox4x32(std::array<std::uint32_t, 4> counter, std::array<std::uint32_t, 2> key) {
+    for (int round = 0; round < 10; ++round) {
+        std::uint64_t product0 = std::uint64_t(0xD2511F53u) * counter[0];
+        std::uint64_t product1 = std::uint64_t(0xCD9E8D57u) * counter[2];
+        counter = { static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0], static_cast<std::uint32_t>(product1),
+                    static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1], static_cast<std::uint32_t>(product0) };
+        key[0] += 0x9E3779B9u;
+        key[1] += 0xBB67AE85u;
+    }
+    return counter;
+}
+
+// Losowe slowa elementu `index` w strumieniu `seed`; attempt rozroznia kolejne proby losowania
+// z odrzucaniem dla tego samego elementu.
+inline std::array<std::uint32_t, 4> datasetRandom(unsigned seed, std::size_t index, std::uint32_t attempt = 0) {
+    std::uint64_t position = index;
+    return philox4x32({ static_cast<std::uint32_t>(position), static_cast<std::uint32_t>(position >> 32), attempt, 0 },
+                      { static_cast<std::uint32_t>(seed), 0x5EED5EEDu });
+}
+
+// Liczba z [0, 1) z 53 bitow dwoch slow.
+inline double datasetUniform(const std::array<std::uint32_t, 4>& words) {
+    std::uint64_t bits = (std::uint64_t(words[0]) << 32 | words[1]) >> 11;
+    return static_cast<double>(bits) * (1.0 / 9007199254740992.0);
+}
+
+// Rozklad Zipfa na {1..n} z wykladnikiem s metoda rejection-inversion Hormanna i Derflingera:
+// stala pamiec zamiast tablicy dystrybuanty, srednio niewiele ponad jedna proba na element.
+class ZipfSampler {
+    double exponent;
+    double hIntegralX1;
+    double hIntegralN;
+    double squeeze;
+    std::uint64_t n;
+
+    // log1p(x) / x i (exp(x) - 1) / x z granica 1 w zerze.
+    static double helper1(double x) { return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x / 2.0; }
+    static double helper2(double x) { return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x / 2.0; }
+
+    double h(double x) const { return std::exp(-exponent * std::log(x)); }
+    double hIntegral(double x) const {
+        double logX = std::log(x);
+        return helper2((1.0 - exponent) * logX) * logX;
+    }
+    double hIntegralInverse(double x) const {
+        double t = std::max(x * (1.0 - exponent), -1.0);
+        return std::exp(helper1(t) * x);
+    }
+
+public:
+    ZipfSampler(std::uint64_t n, double exponent) : exponent(exponent), n(n) {
+        hIntegralX1 = hIntegral(1.5) - 1.0;
+        hIntegralN = hIntegral(static_cast<double>(n) + 0.5);
+        squeeze = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+    }
+
+    std::uint64_t sample(unsigned seed, std::size_t index) const {
+        for (std::uint32_t attempt = 0;; ++attempt) {
+            double u = hIntegralN + datasetUniform(datasetRandom(seed, index, attempt)) * (hIntegralX1 - hIntegralN);
+            double x = hIntegralInverse(u);
+            std::uint64_t k = static_cast<std::uint64_t>(x + 0.5);
+            k = std::min<std::uint64_t>(std::max<std::uint64_t>(k, 1), n);
+            if (static_cast<double>(k) - x <= squeeze || u >= hIntegral(static_cast<double>(k) + 0.5) - h(static_cast<double>(k))) {
+                return k;
+            }
+        }
+    }
+};
+
+// Rozklady danych testowych. partialP to P% poczatkowych elementow rosnaco, reszta losowa
+// i wieksza od nich; sawtooth to sqrt(n) rosnacych serii; fewunique to 16 roznych kluczy;
+// zipf to klucze 1..n z wykladnikiem 1 (kilka kluczy bardzo czestych, dlugi ogon).
+inline const std::vector<std::string>& datasetDistributions() {
+    static const std::vector<std::string> names = {
+        "random", "partial25", "partial50", "partial75", "partial95", "partial99", "partial99.7",
+        "reverse", "organpipe", "sawtooth", "fewunique", "zipf",
+    };
+    return names;
+}
+
+// Generator elementow arr[begin..end) rozkladu `distribution`; kazdy element zalezy tylko od
+// swojego indeksu, wiec zakresy moga byc liczone przez rozne watki.
+inline void generateDatasetRange(const std::string& distribution, int* arr, std::size_t size, unsigned seed, std::size_t begin, std::size_t end) {
+    auto randomWord = [seed](std::size_t i) { return datasetRandom(seed, i)[0]; };
+
+    if (distribution == "random") {
+        for (std::size_t i = begin; i < end; ++i) arr[i] = static_cast<int>(1 + randomWord(i) % 2147483647u);
+    }
+    else if (distribution.compare(0, 7, "partial") == 0) {
+        double percentage = std::stod(distribution.substr(7)) / 100.0;
+        std::size_t sorted = static_cast<std::size_t>(static_cast<double>(size) * percentage);
+        std::size_t tail = size - sorted;
+        for (std::size_t i = begin; i < end; ++i) {
+            arr[i] = i < sorted ? static_cast<int>(i + 1) : static_cast<int>(sorted + 1 + randomWord(i) % tail);
+        }
+    }
+    else if (distribution == "reverse") {
+        for (std::size_t i = begin; i < end; ++i) arr[i] = static_cast<int>(size - i);
+    }
+    else if (distribution == "organpipe") {
+        for (std::size_t i = begin; i < end; ++i) arr[i] = static_cast<int>(i < size / 2 ? i : size - 1 - i);
+    }
+    else if (distribution == "sawtooth") {
+        std::size_t period = std::max<std::size_t>(1, static_cast<std::size_t>(std::sqrt(static_cast<double>(size))));
+        for (std::size_t i = begin; i < end; ++i) arr[i] = static_cast<int>(i % period);
+    }
+    else if (distribution == "fewunique") {
+        for (std::size_t i = begin; i < end; ++i) arr[i] = static_cast<int>(randomWord(i) % 16);
+    }
+    else if (distribution == "zipf") {
+        ZipfSampler zipf(std::max<std::size_t>(size, 1), 1.0);
+        for (std::size_t i = begin; i < end; ++i) arr[i] = static_cast<int>(zipf.sample(seed, i));
+    }
+    else {
+        throw std::invalid_argument("nieznany rozklad danych: " + distribution);
+    }
+}
+
+// Generowanie calego zbioru na `threads` watkach (0 = liczba rdzeni); wynik nie zalezy od threads.
+inline std::vector<int> generateDataset(const std::string& distribution, std::size_t size, unsigned seed, unsigned threads = 0) {
+    if (std::find(datasetDistributions().begin(), datasetDistributions().end(), distribution) == datasetDistributions().end()) {
+        throw std::invalid_argument("nieznany rozklad danych: " + distribution);
+    }
+
+    std::vector<int> values(size);
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(1, size / datasetParallelMinSlice)));
+
+    runParallel(threads, [&](unsigned t) {
+        generateDatasetRange(distribution, values.data(), size, seed, size * t / threads, size * (t + 1) / threads);
+    });
+    return values;
+}
+
+// Naglowek pliku zbioru; plik o innym naglowku albo dlugosci jest generowany od nowa.
+struct DatasetFileHeader {
+    char magic[8];
+    std::uint64_t size;
+    std::uint64_t seed;
+    std::uint64_t elementSize;
+};
+
+constexpr char datasetFileMagic[8] = { 'S', 'O', 'R', 'T', 'D', 'A', 'T', '1' };
+
+// Tylko do odczytu: zbior wygenerowany w pamieci albo plik z pamieci podrecznej odwzorowany mmap.
+class Dataset {
+    std::vector<int> owned;
+    const int* values = nullptr;
+    std::size_t count = 0;
+#if DATASET_MMAP
+    void* mapping = nullptr;
+    std::size_t mappingBytes = 0;
+#endif
+
+    void release() {
+#if DATASET_MMAP
+        if (mapping) munmap(mapping, mappingBytes);
+        mapping = nullptr;
+        mappingBytes = 0;
+#endif
+        owned.clear();
+        values = nullptr;
+        count = 0;
+    }
+
+public:
+    Dataset() = default;
+    explicit Dataset(std::vector<int> data) : owned(std::move(data)), values(owned.data()), count(owned.size()) {}
+
+    Dataset(Dataset&& other) noexcept { *this = std::move(other); }
+    Dataset& operator=(Dataset&& other) noexcept {
+        if (this != &other) {
+            release();
+            owned = std::move(other.owned);
+            values = owned.empty() ? other.values : owned.data();
+            count = other.count;
+#if DATASET_MMAP
+            mapping = other.mapping;
+            mappingBytes = other.mappingBytes;
+            other.mapping = nullptr;
+            other.mappingBytes = 0;
+#endif
+            other.values = nullptr;
+            other.count = 0;
+        }
+        return *this;
+    }
+    Dataset(const Dataset&) = delete;
+    Dataset& operator=(const Dataset&) = delete;
+    ~Dataset() { release(); }
+
+    // Zbior z pliku zapisanego przez writeDatasetFile; pusty Dataset, gdy plik nie istnieje
+    // albo nie pasuje do (size, seed).
+    static Dataset open(const std::string& path, std::size_t size, unsigned seed) {
+        Dataset dataset;
+        std::error_code error;
+        std::uintmax_t bytes = std::filesystem::file_size(path, error);
+        if (error || bytes != sizeof(DatasetFileHeader) + size * sizeof(int)) return dataset;
+
+        auto headerMatches = [&](const DatasetFileHeader& header) {
+            return std::memcmp(header.magic, datasetFileMagic, sizeof(datasetFileMagic)) == 0 && header.size == size &&
+                   header.seed == seed && header.elementSize == sizeof(int);
+        };
+
+#if DATASET_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return dataset;
+        void* mapped = mmap(nullptr, static_cast<std::size_t>(bytes), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) return dataset;
+        dataset.mapping = mapped;
+        dataset.mappingBytes = static_cast<std::size_t>(bytes);
+
+        DatasetFileHeader header;
+        std::memcpy(&header, mapped, sizeof(header));
+        if (!headerMatches(header)) return Dataset();
+        dataset.values = reinterpret_cast<const int*>(static_cast<const char*>(mapped) + sizeof(DatasetFileHeader));
+#else
+        // Bez mmap w owned trafiaja same dane, bez naglowka, wiec przeniesienie obiektu
+        // (values = owned.data()) wskazuje na pierwszy element.
+        BinaryFile file(path, "rb");
+        DatasetFileHeader header;
+        if (file.read(&header, 1) != 1 || !headerMatches(header)) return dataset;
+        dataset.owned.resize(size);
+        if (file.read(dataset.owned.data(), size) != size) return Dataset();
+        dataset.values = dataset.owned.data();
+#endif
+        dataset.count = size;
+        return dataset;
+    }
+
+    bool empty() const { return values == nullptr && count == 0; }
+    const int* data() const { return values; }
+    std::size_t size() const { return count; }
+    const int* begin() const { return values; }
+    const int* end() const { return values + count; }
+};
+
+inline std::string datasetFilePath(const std::string& directory, const std::string& distribution, std::size_t size, unsigned seed) {
+    return (std::filesystem::path(directory) / (distribution + "-" + std::to_string(size) + "-" + std::to_string(seed) + ".bin")).string();
+}
+
+// Zapis do pliku tymczasowego i zmiana nazwy, zeby rownolegle przebiegi nie czytaly polowy pliku.
+inline void writeDatasetFile(const std::string& path, const std::vector<int>& values, unsigned seed) {
+    DatasetFileHeader header;
+    std::memcpy(header.magic, datasetFileMagic, sizeof(datasetFileMagic));
+    header.size = values.size();
+    header.seed = seed;
+    header.elementSize = sizeof(int);
+
+    std::string temporary = path + ".tmp" + std::to_string(std::random_device{}());
+    {
+        BinaryFile file(temporary, "wb");
+        file.write(&header, 1);
+        file.write(values.data(), values.size());
+        file.close();
+    }
+    std::filesystem::rename(temporary, path);
+}
+
+// Zbior (rozklad, rozmiar, ziarno): z pliku w cacheDirectory, jesli jest, w przeciwnym razie
+// generowany rownolegle i zapisywany. Pusty cacheDirectory wylacza pamiec podreczna.
+inline Dataset loadDataset(const std::string& distribution, std::size_t size, unsigned seed, const std::string& cacheDirectory) {
+    bool cached = !cacheDirectory.empty() && size >= datasetCacheMinSize;
+    std::string path;
+    if (cached) {
+        path = datasetFilePath(cacheDirectory, distribution, size, seed);
+        Dataset dataset = Dataset::open(path, size, seed);
+        if (!dataset.empty()) return dataset;
+    }
+
+    std::vector<int> values = generateDataset(distribution, size, seed);
+    if (cached) {
+        std::filesystem::create_directories(cacheDirectory);
+        writeDatasetFile(path, values, seed);
+    }
+    return Dataset(std::move(values));
+}
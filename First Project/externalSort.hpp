@@ -0,0 +1,205 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <algorithm>
+#include <filesystem>
+#include <future>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "parallelIntroSort.hpp"
+#include "loserTree.hpp"
+#include "binaryFile.hpp"
+
+struct ExternalSortConfig {
+    // Pamiec na dane w bajtach: polowa na porcje sortowana, polowa na wczytywanie kolejnej.
+    std::size_t memoryBudget = std::size_t(256) << 20;
+    // Pusty katalog oznacza std::filesystem::temp_directory_path().
+    std::string tempDirectory;
+    // Liczba watkow sortujacych porcje (0 = liczba rdzeni).
+    unsigned threads = 0;
+    // Najmniejszy bufor odczytu jednej serii przy scalaniu; wyznacza maksymalny stopien scalania.
+    std::size_t minMergeBuffer = std::size_t(1) << 20;
+};
+
+// Pliki serii w katalogu tymczasowym, usuwane razem z obiektem.
+class RunFiles {
+    std::filesystem::path directory;
+    std::string prefix;
+    std::size_t counter = 0;
+    std::vector<std::string> paths;
+
+public:
+    explicit RunFiles(const std::string& tempDirectory)
+        : directory(tempDirectory.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(tempDirectory)) {
+        prefix = "extsort_" + std::to_string(std::random_device{}()) + "_";
+    }
+    RunFiles(const RunFiles&) = delete;
+    RunFiles& operator=(const RunFiles&) = delete;
+    ~RunFiles() {
+        std::error_code ignored;
+        for (const auto& path : paths) std::filesystem::remove(path, ignored);
+    }
+
+    std::string create() {
+        paths.push_back((directory / (prefix + std::to_string(counter++) + ".run")).string());
+        return paths.back();
+    }
+
+    void remove(const std::string& path) {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+        paths.erase(std::find(paths.begin(), paths.end(), path));
+    }
+};
+
+// Sekwencyjny odczyt serii duzymi blokami.
+template <typename E>
+class RunReader {
+    BinaryFile file;
+    std::vector<E> buffer;
+    std::size_t pos = 0;
+    std::size_t count = 0;
+
+public:
+    RunReader(const std::string& path, std::size_t bufferElements)
+        : file(path, "rb"), buffer(std::max<std::size_t>(bufferElements, 1)) {}
+
+    bool next(E& value) {
+        if (pos == count) {
+            count = file.read(buffer.data(), buffer.size());
+            pos = 0;
+            if (count == 0) return false;
+        }
+        value = buffer[pos++];
+        return true;
+    }
+};
+
+// Zapis buforowany; close() zapisuje reszte bufora.
+template <typename E>
+class RunWriter {
+    BinaryFile file;
+    std::vector<E> buffer;
+    std::size_t count = 0;
+
+public:
+    RunWriter(const std::string& path, std::size_t bufferElements)
+        : file(path, "wb"), buffer(std::max<std::size_t>(bufferElements, 1)) {}
+
+    void push(const E& value) {
+        buffer[count++] = value;
+        if (count == buffer.size()) {
+            file.write(buffer.data(), count);
+            count = 0;
+        }
+    }
+
+    void close() {
+        file.write(buffer.data(), count);
+        count = 0;
+        file.close();
+    }
+};
+
+// Scala serie `inputs` do pliku `outputPath` jednym przebiegiem drzewa przegranych.
+template <typename E, typename Compare>
+void mergeRunFiles(const std::vector<std::string>& inputs, const std::string& outputPath, std::size_t bufferElements, const Compare& less) {
+    std::vector<RunReader<E>> readers;
+    readers.reserve(inputs.size());
+    for (const auto& path : inputs) readers.emplace_back(path, bufferElements);
+
+    LoserTree<E, Compare> tree(readers.size(), less);
+    E value;
+    for (std::size_t i = 0; i < readers.size(); ++i) {
+        if (readers[i].next(value)) tree.set(i, value);
+    }
+    tree.build();
+
+    RunWriter<E> writer(outputPath, bufferElements);
+    while (!tree.empty()) {
+        writer.push(tree.top());
+        if (readers[tree.topSource()].next(value)) tree.replaceTop(value);
+        else tree.popTop();
+    }
+    writer.close();
+}
+
+// Sortowanie zewnetrzne pliku rekordow E o stalej szerokosci. Porcje wejscia sa czytane w tle,
+// sortowane w miejscu rownolegle parallelIntroSort i zapisywane jako jedna seria kazda,
+// a serie scalane k-krotnie drzewem przegranych - w razie potrzeby w kilku przebiegach,
+// tak zeby bufory wszystkich serii miescily sie w memoryBudget.
+template <typename E, typename Compare = std::less<E>>
+void externalSort(const std::string& inputPath, const std::string& outputPath, const ExternalSortConfig& config = {}, const Compare& less = Compare{}) {
+    static_assert(std::is_trivially_copyable<E>::value, "externalSort wymaga rekordow o stalej szerokosci");
+
+    const std::size_t budgetElements = config.memoryBudget / sizeof(E);
+    const std::size_t chunkElements = budgetElements / 2;
+    const std::size_t minBufferElements = std::max<std::size_t>(config.minMergeBuffer / sizeof(E), 1);
+    if (chunkElements == 0 || budgetElements < 3 * minBufferElements) {
+        throw std::invalid_argument("externalSort: za maly memoryBudget");
+    }
+    if (std::filesystem::file_size(inputPath) % sizeof(E) != 0) {
+        throw std::invalid_argument("externalSort: rozmiar pliku nie jest wielokrotnoscia rozmiaru rekordu");
+    }
+    const unsigned threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    RunFiles runFiles(config.tempDirectory);
+    std::vector<std::string> runs;
+
+    {
+        BinaryFile input(inputPath, "rb");
+        std::vector<E> current(chunkElements);
+        std::vector<E> next(chunkElements);
+        std::size_t currentCount = input.read(current.data(), chunkElements);
+
+        while (currentCount > 0) {
+            std::future<std::size_t> reading = std::async(std::launch::async, [&] {
+                return input.read(next.data(), chunkElements);
+            });
+
+            // Jedna seria na porcje: sortowanie w miejscu, bez buforow spoza memoryBudget.
+            parallelIntroSort(current.data(), currentCount, less, threads);
+            std::string path = runFiles.create();
+            BinaryFile run(path, "wb");
+            run.write(current.data(), currentCount);
+            run.close();
+            runs.push_back(path);
+
+            currentCount = reading.get();
+            std::swap(current, next);
+        }
+    }
+
+    if (runs.empty()) {
+        BinaryFile output(outputPath, "wb");
+        output.close();
+        return;
+    }
+
+    const std::size_t maxFanIn = std::max<std::size_t>(budgetElements / minBufferElements - 1, 2);
+    while (runs.size() > maxFanIn) {
+        std::vector<std::string> merged;
+        for (std::size_t from = 0; from < runs.size(); from += maxFanIn) {
+            std::size_t to = std::min(from + maxFanIn, runs.size());
+            std::vector<std::string> group(runs.begin() + from, runs.begin() + to);
+            if (group.size() == 1) {
+                merged.push_back(group[0]);
+                continue;
+            }
+
+            std::string path = runFiles.create();
+            mergeRunFiles<E>(group, path, budgetElements / (group.size() + 1), less);
+            for (const auto& used : group) runFiles.remove(used);
+            merged.push_back(path);
+        }
+        runs.swap(merged);
+    }
+
+    mergeRunFiles<E>(runs, outputPath, budgetElements / (runs.size() + 1), less);
+}
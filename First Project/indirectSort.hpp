@@ -0,0 +1,132 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "IntroSort.hpp"
+#include "radixSort.hpp"
+
+// Para (klucz, indeks) sortowana zamiast calego rekordu.
+template <typename Key>
+struct KeyIndex {
+    Key key;
+    std::size_t index;
+};
+
+// Permutacja sortujaca: permutation[i] to indeks elementu, ktory po posortowaniu stoi na
+// pozycji i. Sortowane sa tylko pary (keyOf(arr[i]), i); rowne klucze zachowuja kolejnosc.
+template <typename E, typename KeyOf, typename KeyCompare = std::less<>>
+std::vector<std::size_t> argSort(const E* arr, std::size_t size, const KeyOf& keyOf, const KeyCompare& less = KeyCompare{}) {
+    using Key = std::decay_t<decltype(keyOf(arr[0]))>;
+
+    // Klucze calkowite do 32 bitow z domyslnym porzadkiem: klucz i indeks mieszcza sie w jednym
+    // slowie 64-bitowym, ktore sortuje radixSort (indeks w mlodszej polowie daje stabilnosc).
+    if constexpr (isRadixDispatchable<Key, KeyCompare> && sizeof(Key) <= 4) {
+        if (size <= UINT32_MAX) {
+            std::vector<std::uint64_t> packed(size);
+            for (std::size_t i = 0; i < size; ++i) {
+                packed[i] = static_cast<std::uint64_t>(radixKey(keyOf(arr[i]))) << 32 | i;
+            }
+            radixSort(packed.data(), size);
+
+            std::vector<std::size_t> permutation(size);
+            for (std::size_t i = 0; i < size; ++i) permutation[i] = static_cast<std::uint32_t>(packed[i]);
+            return permutation;
+        }
+    }
+
+    std::vector<KeyIndex<Key>> pairs(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        pairs[i].key = keyOf(arr[i]);
+        pairs[i].index = i;
+    }
+    introSort(pairs.data(), size, [&](const KeyIndex<Key>& a, const KeyIndex<Key>& b) {
+        if (less(a.key, b.key)) return true;
+        if (less(b.key, a.key)) return false;
+        return a.index < b.index;
+    });
+
+    std::vector<std::size_t> permutation(size);
+    for (std::size_t i = 0; i < size; ++i) permutation[i] = pairs[i].index;
+    return permutation;
+}
+
+// Pierwsze 8 bajtow klucza jako liczba big-endian (krotsze klucze dopelnione zerami), wiec
+// porzadek prefiksow zgadza sie z leksykograficznym porzadkiem bajtow.
+inline std::uint64_t keyPrefix(const char* data, std::size_t length) {
+    std::uint64_t prefix = 0;
+    std::size_t count = std::min<std::size_t>(length, 8);
+    for (std::size_t i = 0; i < count; ++i) {
+        prefix |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (56 - 8 * i);
+    }
+    return prefix;
+}
+
+// Para (prefiks klucza, wskaznik na rekord) dla dlugich kluczy tekstowych.
+template <typename E>
+struct PrefixRef {
+    std::uint64_t prefix;
+    const E* item;
+};
+
+// argSort dla kluczy tekstowych (keyOf zwraca std::string albo std::string_view): wiekszosc
+// porownan rozstrzyga 8-bajtowy prefiks, pelne klucze sa czytane tylko przy rownych prefiksach.
+template <typename E, typename KeyOf>
+std::vector<std::size_t> argSortByPrefix(const E* arr, std::size_t size, const KeyOf& keyOf) {
+    std::vector<PrefixRef<E>> refs(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        const auto& key = keyOf(arr[i]);
+        refs[i].prefix = keyPrefix(key.data(), key.size());
+        refs[i].item = arr + i;
+    }
+    introSort(refs.data(), size, [&](const PrefixRef<E>& a, const PrefixRef<E>& b) {
+        if (a.prefix != b.prefix) return a.prefix < b.prefix;
+        int order = keyOf(*a.item).compare(keyOf(*b.item));
+        if (order != 0) return order < 0;
+        return a.item < b.item;
+    });
+
+    std::vector<std::size_t> permutation(size);
+    for (std::size_t i = 0; i < size; ++i) permutation[i] = static_cast<std::size_t>(refs[i].item - arr);
+    return permutation;
+}
+
+// Ustawia kolumny wedlug permutacji (jak z argSort) jednym przejsciem po cyklach: kazdy element
+// kazdej kolumny jest przenoszony dokladnie raz, z jednym elementem buforowym na cykl.
+// Permutacja przekazywana jest przez wartosc, bo sluzy jako znacznik odwiedzonych pozycji.
+template <typename... Columns>
+void applyPermutation(std::vector<std::size_t> permutation, Columns*... columns) {
+    const std::size_t size = permutation.size();
+    for (std::size_t i = 0; i < size; ++i) {
+        if (permutation[i] == i) continue;
+
+        std::tuple<Columns...> held(std::move(columns[i])...);
+        std::size_t j = i;
+        while (permutation[j] != i) {
+            std::size_t next = permutation[j];
+            ((columns[j] = std::move(columns[next])), ...);
+            permutation[j] = j;
+            j = next;
+        }
+        std::apply([&](auto&... values) { ((columns[j] = std::move(values)), ...); }, held);
+        permutation[j] = j;
+    }
+}
+
+// Sortowanie szerokich rekordow po kluczu: sortowane sa pary (klucz, indeks), a rekordy
+// przenoszone raz na koniec. Stabilne.
+template <typename E, typename KeyOf, typename KeyCompare = std::less<>>
+void sortByKey(E* arr, std::size_t size, const KeyOf& keyOf, const KeyCompare& less = KeyCompare{}) {
+    applyPermutation(argSort(arr, size, keyOf, less), arr);
+}
+
+// Tryb struktury tablic: sortuje keys[0..size) i tak samo przestawia kolumny danych.
+template <typename Key, typename KeyCompare, typename... Columns>
+void sortColumns(Key* keys, std::size_t size, const KeyCompare& less, Columns*... columns) {
+    std::vector<std::size_t> permutation = argSort(keys, size, [](const Key& key) { return key; }, less);
+    applyPermutation(std::move(permutation), keys, columns...);
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "loserTree.hpp"
+#include "mergeSort.hpp"
+
+// Jak daleko przed biezaca pozycja kazdego zrodla pobierane sa dane. Przy kilkudziesieciu
+// zrodlach sprzetowy prefetcher nie nadaza sledzic wszystkich strumieni.
+constexpr std::size_t kWayMergePrefetchBytes = 512;
+
+// Ponizej tej liczby elementow na watek parallelKWayMerge scala sekwencyjnie.
+constexpr std::size_t parallelKWayMergeMinSlice = std::size_t(1) << 16;
+
+inline void prefetchRead(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#elif SIMD_SORT_X86
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+// Scala posortowane zakresy inputs[i] = (poczatek, koniec) do out jednym przebiegiem drzewa
+// przegranych i zwraca koniec wyjscia. Iteratory moga byc jednoprzebiegowe (strumienie);
+// dla wskaznikow dane kazdego zrodla sa pobierane z wyprzedzeniem. Stabilne: przy rownych
+// kluczach pierwszenstwo ma zrodlo o mniejszym indeksie.
+template <typename Iterator, typename OutputIterator, typename Compare = std::less<typename std::iterator_traits<Iterator>::value_type>>
+OutputIterator kWayMerge(std::vector<std::pair<Iterator, Iterator>> inputs, OutputIterator out, const Compare& less = Compare{}) {
+    using E = typename std::iterator_traits<Iterator>::value_type;
+
+    LoserTree<E, Compare> tree(inputs.size(), less);
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        if (inputs[i].first != inputs[i].second) tree.set(i, *inputs[i].first);
+    }
+    tree.build();
+
+    while (!tree.empty()) {
+        std::size_t source = tree.topSource();
+        *out = tree.top();
+        ++out;
+
+        Iterator& position = inputs[source].first;
+        ++position;
+        if (position == inputs[source].second) {
+            tree.popTop();
+            continue;
+        }
+        if constexpr (std::is_pointer<Iterator>::value) {
+            prefetchRead(reinterpret_cast<const char*>(position) + kWayMergePrefetchBytes);
+        }
+        tree.replaceTop(*position);
+    }
+    return out;
+}
+
+// Podzial wyjscia k-krotnego scalenia: split[i] elementow zrodla i nalezy do pierwszych rank
+// elementow wyniku (porzadek jak w kWayMerge, przy rownych kluczach decyduje numer zrodla).
+// Kazdy krok bierze srodek najszerszego okna jako element osiowy, liczy jego pozycje we
+// wszystkich zrodlach wyszukiwaniem binarnym i zaweza okna - uogolnienie coRank na k zrodel.
+template <typename E, typename Compare>
+std::vector<std::size_t> multiwayCoRank(std::size_t rank, const std::vector<std::pair<const E*, const E*>>& inputs, const Compare& less) {
+    const std::size_t k = inputs.size();
+    std::vector<std::size_t> lo(k, 0), hi(k), below(k);
+    for (std::size_t i = 0; i < k; ++i) hi[i] = static_cast<std::size_t>(inputs[i].second - inputs[i].first);
+    if (k == 0) return lo;
+
+    while (true) {
+        std::size_t widest = 0;
+        for (std::size_t i = 1; i < k; ++i) {
+            if (hi[i] - lo[i] > hi[widest] - lo[widest]) widest = i;
+        }
+        if (hi[widest] == lo[widest]) return lo;
+
+        std::size_t position = lo[widest] + (hi[widest] - lo[widest]) / 2;
+        const E& pivot = inputs[widest].first[position];
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < k; ++i) {
+            const E* first = inputs[i].first;
+            if (i < widest) below[i] = std::upper_bound(first + lo[i], first + hi[i], pivot, less) - first;
+            else if (i > widest) below[i] = std::lower_bound(first + lo[i], first + hi[i], pivot, less) - first;
+            else below[i] = position;
+            count += below[i];
+        }
+
+        if (count == rank) return below;
+        if (count < rank) {
+            lo = below;
+            lo[widest] = position + 1;
+        }
+        else {
+            hi = below;
+        }
+    }
+}
+
+// Rownolegle scalanie: wyjscie dzielone jest na rowne fragmenty, granice fragmentow
+// we wszystkich zrodlach wyznacza multiwayCoRank, a kazdy watek scala swoj fragment osobno.
+template <typename E, typename Compare = std::less<E>>
+E* parallelKWayMerge(const std::vector<std::pair<const E*, const E*>>& inputs, E* out, const Compare& less = Compare{}, unsigned threads = 0) {
+    std::size_t total = 0;
+    for (const auto& input : inputs) total += static_cast<std::size_t>(input.second - input.first);
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(1, total / parallelKWayMergeMinSlice)));
+    if (threads < 2) return kWayMerge(inputs, out, less);
+
+    std::vector<std::vector<std::size_t>> splits(threads + 1);
+    runParallel(threads + 1, [&](unsigned t) {
+        splits[t] = multiwayCoRank(total * t / threads, inputs, less);
+    });
+
+    runParallel(threads, [&](unsigned t) {
+        std::vector<std::pair<const E*, const E*>> slice(inputs.size());
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            slice[i].first = inputs[i].first + splits[t][i];
+            slice[i].second = inputs[i].first + splits[t + 1][i];
+        }
+        kWayMerge(std::move(slice), out + total * t / threads, less);
+    });
+    return out + total;
+}
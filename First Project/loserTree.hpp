@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Drzewo przegranych dla scalania k posortowanych zrodel. Wezly wewnetrzne pamietaja
+// przegranego swojego meczu razem z jego kluczem, wiec wymiana zwyciezcy to log2(k) porownan
+// na jednej sciezce do korzenia bez odwolan do tablic zrodel. Przy rownych kluczach wygrywa
+// zrodlo o mniejszym indeksie (stabilnosc).
+template <typename E, typename Compare = std::less<E>>
+class LoserTree {
+    struct Node {
+        E key;
+        std::size_t source;
+        bool exhausted;
+    };
+
+    // tree[0] to zwyciezca, tree[1..k) przegrani; liscie (k..2k) sa tylko w `leaves`.
+    std::vector<Node> tree;
+    std::vector<Node> leaves;
+    std::size_t k;
+    Compare less;
+
+    bool beats(const Node& a, const Node& b) const {
+        if (a.exhausted) return false;
+        if (b.exhausted) return true;
+        if (less(a.key, b.key)) return true;
+        if (less(b.key, a.key)) return false;
+        return a.source < b.source;
+    }
+
+    Node build(std::size_t node) {
+        if (node >= k) return leaves[node - k];
+
+        Node left = build(2 * node);
+        Node right = build(2 * node + 1);
+        if (beats(left, right)) {
+            tree[node] = std::move(right);
+            return left;
+        }
+        tree[node] = std::move(left);
+        return right;
+    }
+
+    void replay(Node winner) {
+        for (std::size_t node = (k + winner.source) / 2; node > 0; node /= 2) {
+            if (beats(tree[node], winner)) {
+                std::swap(tree[node], winner);
+            }
+        }
+        tree[0] = std::move(winner);
+    }
+
+public:
+    explicit LoserTree(std::size_t sources, const Compare& less = Compare{})
+        : tree(sources > 0 ? sources : 1), leaves(sources), k(sources), less(less) {
+        for (std::size_t i = 0; i < sources; ++i) {
+            leaves[i].source = i;
+            leaves[i].exhausted = true;
+        }
+        tree[0].exhausted = true;
+    }
+
+    std::size_t size() const { return k; }
+
+    // Ustawienie pierwszych kluczy zrodel; po wszystkich set()/close() trzeba wywolac build().
+    void set(std::size_t source, const E& key) {
+        leaves[source].key = key;
+        leaves[source].exhausted = false;
+    }
+
+    void close(std::size_t source) { leaves[source].exhausted = true; }
+
+    void build() {
+        if (k == 0) return;
+        tree[0] = build(1);
+        leaves.clear();
+        leaves.shrink_to_fit();
+    }
+
+    bool empty() const { return tree[0].exhausted; }
+
+    std::size_t topSource() const { return tree[0].source; }
+
+    const E& top() const { return tree[0].key; }
+
+    // Zwyciezca dostaje nastepny klucz ze swojego zrodla.
+    void replaceTop(const E& key) {
+        Node winner{ key, tree[0].source, false };
+        replay(std::move(winner));
+    }
+
+    // Zrodlo zwyciezcy sie wyczerpalo.
+    void popTop() {
+        Node winner = std::move(tree[0]);
+        winner.exhausted = true;
+        replay(std::move(winner));
+    }
+};
@@ -3,23 +3,37 @@
 #include <functional>
 #include <algorithm> 
 #include <stdexcept> 
+#include <thread>
+#include <exception>
+#include <vector>
+#include "InsertionSort.hpp"
+#include "SortWorkspace.hpp"
+#include "simdSort.hpp"
+#include "simdMerge.hpp"
+#include "sortInstrumentation.hpp"
+#include "parallelTasks.hpp"
 
 
-template <typename E, typename Compare>
+// Liscie rekursji mergeSort tej wielkosci moga byc sortowane siecia SIMD.
+constexpr std::size_t mergeSortLeafSize = 16;
+
+template <typename E, typename Compare, typename Instrumentation = NoInstrumentation>
 void merge(E* arr, E* buffer, std::size_t left, std::size_t mid, std::size_t right, const Compare& less) {
   
     std::copy(arr + left, arr + right + 1, buffer + left);
+    Instrumentation::move(2 * (right - left + 1));
+    if (simdMerge<E, Compare>(buffer + left, mid - left + 1, buffer + mid + 1, right - mid, arr + left)) return;
     
     std::size_t i = left;       
     std::size_t j = mid + 1;    
     std::size_t k = left;       
 
     while (i <= mid && j <= right) {
-        if (less(buffer[i], buffer[j])) {
-            arr[k++] = buffer[i++];
+        if (less(buffer[j], buffer[i])) {
+            arr[k++] = buffer[j++];
         }
         else {
-            arr[k++] = buffer[j++];
+            arr[k++] = buffer[i++];
         }
     }
 
@@ -30,27 +44,40 @@ void merge(E* arr, E* buffer, std::size_t left, std::size_t mid, std::size_t rig
    
 }
 
-template <typename E, typename Compare>
-void mergeSort_recursive(E* arr, E* buffer, std::size_t left, std::size_t right, const Compare& less) {
+template <typename E, typename Compare, typename Instrumentation = NoInstrumentation>
+void mergeSort_recursive(E* arr, E* buffer, std::size_t left, std::size_t right, const Compare& less, std::size_t depth = 0) {
     if (left >= right) return;
+    Instrumentation::depth(depth);
+    if (right - left < mergeSortLeafSize && useSimdStableSmallSort<E, Compare>(right - left + 1)) {
+        smallSort(arr, left, right, less);
+        return;
+    }
 
     std::size_t mid = left + (right - left) / 2;
-    mergeSort_recursive(arr, buffer, left, mid, less);
-    mergeSort_recursive(arr, buffer, mid + 1, right, less);
-    merge(arr, buffer, left, mid, right, less);
+    mergeSort_recursive<E, Compare, Instrumentation>(arr, buffer, left, mid, less, depth + 1);
+    mergeSort_recursive<E, Compare, Instrumentation>(arr, buffer, mid + 1, right, less, depth + 1);
+    merge<E, Compare, Instrumentation>(arr, buffer, left, mid, right, less);
 }
 
-template <typename E, typename Compare = std::less<E>> 
+// Instrumentation liczy porownania, przeniesienia (kopia do bufora i zapis wyniku), glebokosc
+// rekursji i bajty bufora.
+template <typename E, typename Compare = std::less<E>, typename Instrumentation = NoInstrumentation>
 void mergeSort(E* arr, std::size_t size, const Compare& less = Compare{}) {
     if (size < 2) return; 
+    if constexpr (needsCountingCompare<Instrumentation, Compare>) {
+        using Counting = CountingCompare<Compare, Instrumentation>;
+        mergeSort<E, Counting, Instrumentation>(arr, size, Counting{ less });
+        return;
+    }
 
     E* buffer = new (std::nothrow) E[size];
     if (!buffer) {
         throw std::bad_alloc(); 
     }
+    Instrumentation::allocate(size * sizeof(E));
 
     try {
-        mergeSort_recursive(arr, buffer, 0, size - 1, less);
+        mergeSort_recursive<E, Compare, Instrumentation>(arr, buffer, 0, size - 1, less);
     }
     catch (...) {
         delete[] buffer; 
@@ -58,4 +85,189 @@ void mergeSort(E* arr, std::size_t size, const Compare& less = Compare{}) {
     }
 
     delete[] buffer; 
-}
\ No newline at end of file
+}
+
+template <typename E, typename Compare>
+void mergeSort(E* arr, std::size_t size, const Compare& less, ScratchSpan<E> scratch) {
+    if (size < 2) return;
+    mergeSort_recursive(arr, requireScratch(scratch, size, "mergeSort"), 0, size - 1, less);
+}
+
+template <typename E, typename Compare>
+void mergeSort(E* arr, std::size_t size, const Compare& less, SortWorkspace<E>& workspace) {
+    mergeSort(arr, size, less, workspace.reserve(size));
+}
+
+// Ponizej tego rozmiaru parallelMergeSort przechodzi na sekwencyjne mergeSort_recursive.
+constexpr std::size_t parallelMergeSortCutoff = std::size_t(1) << 16;
+
+// Zwraca ile z pierwszych k elementow scalenia a[0..n) i b[0..m) pochodzi z a.
+// Przy rownych kluczach pierwszenstwo ma a, wiec podzial zachowuje stabilnosc.
+template <typename E, typename Compare>
+std::size_t coRank(std::size_t k, const E* a, std::size_t n, const E* b, std::size_t m, const Compare& less) {
+    std::size_t lo = k > m ? k - m : 0;
+    std::size_t hi = std::min(k, n);
+
+    while (lo < hi) {
+        std::size_t i = lo + (hi - lo) / 2;
+        if (!less(b[k - i - 1], a[i])) {
+            lo = i + 1;
+        }
+        else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+template <typename E, typename Compare>
+void mergeRanges(const E* a, const E* aEnd, const E* b, const E* bEnd, E* out, const Compare& less) {
+    if (simdMerge<E, Compare>(a, aEnd - a, b, bEnd - b, out)) return;
+    while (a != aEnd && b != bEnd) {
+        if (less(*b, *a)) {
+            *out++ = *b++;
+        }
+        else {
+            *out++ = *a++;
+        }
+    }
+    out = std::copy(a, aEnd, out);
+    std::copy(b, bEnd, out);
+}
+
+// Scalanie arr[left..mid] i arr[mid+1..right]: wyjscie dzielone jest na rowne kawalki,
+// a granice w obu polowkach wyznacza coRank, wiec watki pisza do rozlacznych fragmentow.
+template <typename E, typename Compare>
+void parallelMerge(E* arr, E* buffer, std::size_t left, std::size_t mid, std::size_t right, const Compare& less, unsigned threads) {
+    const std::size_t total = right - left + 1;
+    const std::size_t n = mid - left + 1;
+    const std::size_t m = right - mid;
+    const E* a = buffer + left;
+    const E* b = buffer + mid + 1;
+
+    runParallel(threads, [&](unsigned t) {
+        std::size_t from = left + total * t / threads;
+        std::size_t to = left + total * (t + 1) / threads;
+        std::copy(arr + from, arr + to, buffer + from);
+    });
+
+    runParallel(threads, [&](unsigned t) {
+        std::size_t k0 = total * t / threads;
+        std::size_t k1 = total * (t + 1) / threads;
+        std::size_t i0 = coRank(k0, a, n, b, m, less);
+        std::size_t i1 = coRank(k1, a, n, b, m, less);
+        mergeRanges(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1), arr + left + k0, less);
+    });
+}
+
+template <typename E, typename Compare>
+void parallelMergeSort_recursive(E* arr, E* buffer, std::size_t left, std::size_t right, const Compare& less, unsigned threads, std::size_t cutoff) {
+    if (threads < 2 || right - left + 1 <= cutoff) {
+        mergeSort_recursive(arr, buffer, left, right, less);
+        return;
+    }
+
+    std::size_t mid = left + (right - left) / 2;
+    unsigned leftThreads = threads / 2;
+    runParallel(2, [&](unsigned t) {
+        if (t == 0) parallelMergeSort_recursive(arr, buffer, left, mid, less, leftThreads, cutoff);
+        else parallelMergeSort_recursive(arr, buffer, mid + 1, right, less, threads - leftThreads, cutoff);
+    });
+    parallelMerge(arr, buffer, left, mid, right, less, threads);
+}
+
+template <typename E, typename Compare>
+void parallelMergeSort(E* arr, std::size_t size, const Compare& less, ScratchSpan<E> scratch, unsigned threads = 0, std::size_t cutoff = parallelMergeSortCutoff) {
+    if (size < 2) return;
+    E* buffer = requireScratch(scratch, size, "parallelMergeSort");
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (cutoff < 2) cutoff = 2;
+
+    parallelMergeSort_recursive(arr, buffer, 0, size - 1, less, threads, cutoff);
+}
+
+template <typename E, typename Compare>
+void parallelMergeSort(E* arr, std::size_t size, const Compare& less, SortWorkspace<E>& workspace, unsigned threads = 0, std::size_t cutoff = parallelMergeSortCutoff) {
+    parallelMergeSort(arr, size, less, workspace.reserve(size), threads, cutoff);
+}
+
+// Stabilne sortowanie przez scalanie na `threads` watkach (0 = liczba rdzeni).
+template <typename E, typename Compare = std::less<E>>
+void parallelMergeSort(E* arr, std::size_t size, const Compare& less = Compare{}, unsigned threads = 0, std::size_t cutoff = parallelMergeSortCutoff) {
+    if (size < 2) return;
+
+    E* buffer = new (std::nothrow) E[size];
+    if (!buffer) {
+        throw std::bad_alloc();
+    }
+
+    try {
+        parallelMergeSort(arr, size, less, ScratchSpan<E>{ buffer, size }, threads, cutoff);
+    }
+    catch (...) {
+        delete[] buffer;
+        throw;
+    }
+
+    delete[] buffer;
+}
+
+// Dlugosc serii sortowanych wstepnie przez wstawianie w mergeSortBottomUp.
+constexpr std::size_t mergeSortBottomUpRun = 16;
+
+// Iteracyjne scalanie wstepujace: kolejne przebiegi scalaja z arr do buffer i z powrotem,
+// wiec kazdy element jest przepisywany raz na przebieg, a kopia koncowa jest tylko przy
+// nieparzystej liczbie przebiegow.
+template <typename E, typename Compare>
+void mergeSortBottomUp(E* arr, E* buffer, std::size_t size, const Compare& less) {
+    for (std::size_t lo = 0; lo < size; lo += mergeSortBottomUpRun) {
+        std::size_t hi = std::min(lo + mergeSortBottomUpRun, size);
+        stableSmallSort(arr, lo, hi - 1, less);
+    }
+
+    E* src = arr;
+    E* dst = buffer;
+    for (std::size_t width = mergeSortBottomUpRun; width < size; width *= 2) {
+        for (std::size_t lo = 0; lo < size; lo += 2 * width) {
+            std::size_t mid = std::min(lo + width, size);
+            std::size_t hi = std::min(lo + 2 * width, size);
+            mergeRanges(src + lo, src + mid, src + mid, src + hi, dst + lo, less);
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != arr) {
+        std::copy(src, src + size, arr);
+    }
+}
+
+template <typename E, typename Compare = std::less<E>>
+void mergeSortBottomUp(E* arr, std::size_t size, const Compare& less = Compare{}) {
+    if (size < 2) return;
+
+    E* buffer = new (std::nothrow) E[size];
+    if (!buffer) {
+        throw std::bad_alloc();
+    }
+
+    try {
+        mergeSortBottomUp(arr, buffer, size, less);
+    }
+    catch (...) {
+        delete[] buffer;
+        throw;
+    }
+
+    delete[] buffer;
+}
+
+template <typename E, typename Compare>
+void mergeSortBottomUp(E* arr, std::size_t size, const Compare& less, ScratchSpan<E> scratch) {
+    if (size < 2) return;
+    mergeSortBottomUp(arr, requireScratch(scratch, size, "mergeSortBottomUp"), size, less);
+}
+
+template <typename E, typename Compare>
+void mergeSortBottomUp(E* arr, std::size_t size, const Compare& less, SortWorkspace<E>& workspace) {
+    mergeSortBottomUp(arr, size, less, workspace.reserve(size));
+}
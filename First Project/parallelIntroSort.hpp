@@ -0,0 +1,508 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "IntroSort.hpp"
+#include "mergeSort.hpp"
+
+// Zakresy nie wieksze od tego progu konczy sekwencyjny introSort (w miejscu).
+constexpr std::size_t parallelIntroSortLeafSize = 2048;
+
+// Rozmiar bloku w bajtach - jednostka, w ktorej elementy sa przenoszone miedzy kubelkami.
+constexpr std::size_t parallelIntroSortBlockBytes = 2048;
+
+// Maksymalnie 2^8 kubelkow w jednym kroku (plus tyle samo kubelkow rownych kluczy).
+constexpr int parallelIntroSortMaxLogBuckets = 8;
+
+// Ile elementow klasyfikuje sie naraz - niezalezne zejscia po drzewie nakladaja sie w potoku.
+constexpr std::size_t parallelIntroSortBatch = 16;
+
+template <typename E>
+constexpr std::size_t sampleSortBlockSize() {
+    return std::max<std::size_t>(1, parallelIntroSortBlockBytes / sizeof(E));
+}
+
+// Bezgaleziowy klasyfikator: K-1 splitterow w niejawnym drzewie BST (uklad jak w kopcu),
+// zejscie i = 2i + less(tree[i], e) nie ma skokow warunkowych. Element rowny splitterowi
+// trafia do osobnego kubelka rownych kluczy, ktory nie wymaga dalszego sortowania, wiec
+// kazdy krok zmniejsza zakresy nawet przy wielu duplikatach.
+template <typename E, typename Compare>
+class SampleSortClassifier {
+    std::vector<E> tree;
+    std::vector<E> splitters;
+    std::size_t k = 2;
+    int logBuckets = 1;
+
+    void build(std::size_t node, std::size_t lo, std::size_t hi) {
+        if (lo >= hi) return;
+        std::size_t mid = lo + (hi - lo) / 2;
+        tree[node] = splitters[mid];
+        build(2 * node, lo, mid);
+        build(2 * node + 1, mid + 1, hi);
+    }
+
+public:
+    // sorted - rosnace, unikalne splittery (co najmniej jeden); dopelniane ostatnim do 2^logBuckets.
+    void build(const std::vector<E>& sorted, int logBuckets) {
+        this->logBuckets = logBuckets;
+        k = std::size_t(1) << logBuckets;
+        splitters.assign(k, sorted.back());
+        std::copy(sorted.begin(), sorted.end(), splitters.begin());
+        tree.resize(k);
+        build(1, 0, k - 1);
+    }
+
+    // Liczba kubelkow razem z kubelkami rownych kluczy (nieparzyste indeksy).
+    std::size_t buckets() const { return 2 * k; }
+
+    static bool isEqualityBucket(std::size_t bucket) { return bucket & 1; }
+
+    void classify(const E* elements, std::size_t count, std::size_t* out, const Compare& less) const {
+        for (std::size_t i = 0; i < count; ++i) out[i] = 1;
+        for (int level = 0; level < logBuckets; ++level) {
+            for (std::size_t i = 0; i < count; ++i) {
+                out[i] = 2 * out[i] + static_cast<std::size_t>(less(tree[out[i]], elements[i]));
+            }
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            std::size_t b = out[i] - k;
+            std::size_t equal = static_cast<std::size_t>(b + 1 < k) & static_cast<std::size_t>(!less(elements[i], splitters[b]));
+            out[i] = 2 * b + equal;
+        }
+    }
+
+    std::size_t classify(const E& element, const Compare& less) const {
+        std::size_t bucket;
+        classify(&element, 1, &bucket, less);
+        return bucket;
+    }
+};
+
+// Pamiec jednego watku: bufory blokow dla kazdego kubelka i bufory wymiany permutacji.
+// Zachowywana miedzy krokami, wiec alokacje nie powtarzaja sie w rekursji.
+template <typename E>
+struct SampleSortThreadData {
+    std::vector<E> buffers;
+    std::vector<std::size_t> fill;
+    std::vector<std::size_t> counts;
+    std::vector<E> swap;
+    std::vector<E> stash;
+    std::size_t stashBegin = 0;
+    std::size_t fullEnd = 0;
+
+    void prepare(std::size_t buckets, std::size_t block) {
+        if (buffers.size() < buckets * block) buffers.resize(buckets * block);
+        if (swap.size() < 2 * block) swap.resize(2 * block);
+        fill.assign(buckets, 0);
+        counts.assign(buckets, 0);
+    }
+};
+
+// Jeden krok podzialu arr[0..n) na kubelki przez `threads` watkow, w miejscu:
+// 1. kazdy watek klasyfikuje swoj pas do buforow blokow, pelne bloki odkladajac na poczatek pasa,
+// 2. puste bloki sa przesuwane tak, by w obszarze kazdego kubelka pelne bloki byly na poczatku,
+// 3. bloki sa permutowane na miejsca swoich kubelkow (watki zaczynaja od roznych kubelkow),
+// 4. niepelne bloki z buforow i nadmiar wyrownania sa dopisywane na brzegach kubelkow.
+// Zwraca granice kubelkow (buckets() + 1 pozycji).
+template <typename E, typename Compare>
+class SampleSortStep {
+    E* arr;
+    std::size_t n;
+    const Compare& less;
+    SampleSortThreadData<E>* data;
+    unsigned threads;
+
+    const std::size_t block = sampleSortBlockSize<E>();
+    SampleSortClassifier<E, Compare> classifier;
+    std::size_t numBuckets = 0;
+    std::size_t stripeSize = 0;
+
+    std::vector<std::size_t> bucketStart;
+    std::vector<std::size_t> delimiter;
+    std::vector<std::size_t> writePos;
+    std::vector<std::size_t> readEnd;
+    std::vector<E> overflow;
+    std::size_t overflowSlot = 0;
+    bool overflowUsed = false;
+
+    std::size_t stripeBegin(unsigned t) const { return std::min(t * stripeSize, n); }
+    std::size_t stripeEnd(unsigned t) const { return t + 1 == threads ? n : std::min((t + 1) * stripeSize, n); }
+
+    void chooseSplitters() {
+        int logBuckets = 1;
+        while (logBuckets < parallelIntroSortMaxLogBuckets &&
+               (n >> (logBuckets + 1)) >= parallelIntroSortLeafSize) {
+            ++logBuckets;
+        }
+        const std::size_t k = std::size_t(1) << logBuckets;
+        const std::size_t oversampling = std::max<std::size_t>(1, static_cast<std::size_t>(0.2 * std::log2(n)));
+        const std::size_t sampleSize = std::min(n, k * oversampling - 1);
+
+        static thread_local std::mt19937 generator(std::random_device{}());
+        for (std::size_t i = 0; i < sampleSize; ++i) {
+            std::uniform_int_distribution<std::size_t> pick(i, n - 1);
+            std::swap(arr[i], arr[pick(generator)]);
+        }
+        introSort(arr, sampleSize, less);
+
+        std::vector<E> splitters;
+        splitters.reserve(k - 1);
+        for (std::size_t i = 1; i < k; ++i) {
+            const E& candidate = arr[std::min(i * oversampling, sampleSize) - 1];
+            if (splitters.empty() || less(splitters.back(), candidate)) splitters.push_back(candidate);
+        }
+        classifier.build(splitters, logBuckets);
+        numBuckets = classifier.buckets();
+    }
+
+    bool isFullBlock(std::size_t pos) const {
+        unsigned stripe = static_cast<unsigned>(std::min<std::size_t>(pos / stripeSize, threads - 1));
+        return pos < data[stripe].fullEnd;
+    }
+
+    void classifyStripe(unsigned t) {
+        SampleSortThreadData<E>& local = data[t];
+        const std::size_t begin = stripeBegin(t);
+        const std::size_t end = stripeEnd(t);
+        std::size_t write = begin;
+        std::size_t bucketOf[parallelIntroSortBatch];
+
+        for (std::size_t pos = begin; pos < end; pos += parallelIntroSortBatch) {
+            const std::size_t count = std::min(parallelIntroSortBatch, end - pos);
+            classifier.classify(arr + pos, count, bucketOf, less);
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::size_t b = bucketOf[i];
+                E* buffer = local.buffers.data() + b * block;
+                buffer[local.fill[b]++] = std::move(arr[pos + i]);
+                if (local.fill[b] == block) {
+                    std::move(buffer, buffer + block, arr + write);
+                    write += block;
+                    local.counts[b] += block;
+                    local.fill[b] = 0;
+                }
+            }
+        }
+        for (std::size_t b = 0; b < numBuckets; ++b) local.counts[b] += local.fill[b];
+        local.fullEnd = write;
+    }
+
+    // Dwa wskazniki w obszarze kubelka: pierwszy szuka pustego bloku od lewej, drugi pelnego od prawej.
+    void compactBuckets(std::size_t from, std::size_t to) {
+        const std::size_t lastBlockEnd = n / block * block;
+        for (std::size_t b = from; b < to; ++b) {
+            std::size_t lo = delimiter[b];
+            std::size_t hi = std::min(delimiter[b + 1], lastBlockEnd);
+            writePos[b] = lo;
+            if (hi <= lo) {
+                readEnd[b] = lo;
+                continue;
+            }
+
+            std::size_t emptySlot = lo;
+            std::size_t fullEnd = hi;
+            while (true) {
+                while (emptySlot < fullEnd && isFullBlock(emptySlot)) emptySlot += block;
+                while (fullEnd > emptySlot && !isFullBlock(fullEnd - block)) fullEnd -= block;
+                if (emptySlot >= fullEnd) break;
+                std::move(arr + fullEnd - block, arr + fullEnd, arr + emptySlot);
+                emptySlot += block;
+                fullEnd -= block;
+            }
+            readEnd[b] = emptySlot;
+        }
+    }
+
+    void permuteBlocks(unsigned t, std::vector<std::mutex>& locks) {
+        E* current = data[t].swap.data();
+        E* incoming = current + block;
+        const std::size_t primary = t * numBuckets / threads;
+
+        for (std::size_t step = 0; step < numBuckets;) {
+            const std::size_t source = (primary + step) % numBuckets;
+            {
+                std::lock_guard<std::mutex> guard(locks[source]);
+                if (readEnd[source] <= writePos[source]) {
+                    ++step;
+                    continue;
+                }
+                readEnd[source] -= block;
+                std::move(arr + readEnd[source], arr + readEnd[source] + block, current);
+            }
+
+            std::size_t target = classifier.classify(current[0], less);
+            while (true) {
+                std::size_t slot;
+                bool occupied;
+                {
+                    std::lock_guard<std::mutex> guard(locks[target]);
+                    slot = writePos[target];
+                    writePos[target] += block;
+                    occupied = slot < readEnd[target];
+                }
+
+                if (occupied) {
+                    std::move(arr + slot, arr + slot + block, incoming);
+                    std::move(current, current + block, arr + slot);
+                    std::swap(current, incoming);
+                    target = classifier.classify(current[0], less);
+                    continue;
+                }
+                if (slot + block > n) {
+                    std::move(current, current + block, overflow.data());
+                    overflowSlot = slot;
+                    overflowUsed = true;
+                }
+                else {
+                    std::move(current, current + block, arr + slot);
+                }
+                break;
+            }
+        }
+    }
+
+    std::pair<std::size_t, std::size_t> bucketRange(unsigned t) const {
+        return { t * numBuckets / threads, (t + 1) * numBuckets / threads };
+    }
+
+    // Nadmiar ostatniego bloku kubelka lezy w naglowku kolejnych kubelkow; jesli naleza one do
+    // innego watku, ten fragment jest kopiowany przed uzupelnianiem brzegow.
+    void stashBoundary(unsigned t) {
+        SampleSortThreadData<E>& local = data[t];
+        const std::size_t rangeEnd = bucketStart[bucketRange(t).second];
+        const std::size_t stashEnd = std::min(rangeEnd + block, n);
+        local.stashBegin = rangeEnd;
+        local.stash.assign(arr + rangeEnd, arr + stashEnd);
+    }
+
+    void fillBucketEdges(unsigned t) {
+        const std::pair<std::size_t, std::size_t> range = bucketRange(t);
+        SampleSortThreadData<E>& local = data[t];
+        const std::size_t rangeEnd = bucketStart[range.second];
+
+        auto overflowElement = [&](std::size_t pos) -> E& {
+            if (overflowUsed && pos >= n) return overflow[pos - overflowSlot];
+            if (pos >= rangeEnd) return local.stash[pos - local.stashBegin];
+            return arr[pos];
+        };
+
+        for (std::size_t b = range.first; b < range.second; ++b) {
+            const std::size_t start = bucketStart[b];
+            const std::size_t end = bucketStart[b + 1];
+            const std::size_t headEnd = std::min(delimiter[b], end);
+            const std::size_t written = writePos[b];
+
+            std::size_t dest = start;
+            auto put = [&](E& value) {
+                if (dest == headEnd) dest = std::max(written, headEnd);
+                arr[dest++] = std::move(value);
+            };
+
+            for (std::size_t pos = std::max(end, delimiter[b]); pos < written; ++pos) put(overflowElement(pos));
+            for (unsigned s = 0; s < threads; ++s) {
+                E* buffer = data[s].buffers.data() + b * block;
+                for (std::size_t i = 0; i < data[s].fill[b]; ++i) put(buffer[i]);
+            }
+        }
+    }
+
+public:
+    SampleSortStep(E* arr, std::size_t n, const Compare& less, SampleSortThreadData<E>* data, unsigned threads)
+        : arr(arr), n(n), less(less), data(data), threads(threads) {}
+
+    std::vector<std::size_t> run() {
+        chooseSplitters();
+
+        const std::size_t blocks = n / block;
+        threads = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(threads, blocks)));
+        stripeSize = std::max<std::size_t>(1, (blocks + threads - 1) / threads) * block;
+        for (unsigned t = 0; t < threads; ++t) data[t].prepare(numBuckets, block);
+
+        runParallel(threads, [&](unsigned t) { classifyStripe(t); });
+
+        bucketStart.assign(numBuckets + 1, 0);
+        delimiter.assign(numBuckets + 1, 0);
+        for (std::size_t b = 0; b < numBuckets; ++b) {
+            std::size_t total = 0;
+            for (unsigned t = 0; t < threads; ++t) total += data[t].counts[b];
+            bucketStart[b + 1] = bucketStart[b] + total;
+        }
+        for (std::size_t b = 0; b <= numBuckets; ++b) {
+            delimiter[b] = (bucketStart[b] + block - 1) / block * block;
+        }
+
+        writePos.assign(numBuckets, 0);
+        readEnd.assign(numBuckets, 0);
+        runParallel(threads, [&](unsigned t) {
+            std::pair<std::size_t, std::size_t> range = bucketRange(t);
+            compactBuckets(range.first, range.second);
+        });
+
+        overflow.resize(block);
+        std::vector<std::mutex> locks(numBuckets);
+        runParallel(threads, [&](unsigned t) { permuteBlocks(t, locks); });
+
+        if (overflowUsed) {
+            std::move(overflow.begin(), overflow.begin() + (n - overflowSlot), arr + overflowSlot);
+        }
+
+        runParallel(threads, [&](unsigned t) { stashBoundary(t); });
+        runParallel(threads, [&](unsigned t) { fillBucketEdges(t); });
+        return bucketStart;
+    }
+};
+
+// Pula zadan z podkradaniem: kazdy watek bierze zadania z konca swojej kolejki, a gdy
+// ta jest pusta - z poczatku kolejki innego watku (tam leza wieksze, starsze zadania).
+class SortTaskPool {
+public:
+    struct Task {
+        std::size_t begin;
+        std::size_t size;
+    };
+
+private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<Queue> queues;
+    std::atomic<std::size_t> pending{ 0 };
+    std::atomic<bool> failed{ false };
+
+    bool take(unsigned worker, Task& task) {
+        {
+            std::lock_guard<std::mutex> guard(queues[worker].lock);
+            if (!queues[worker].tasks.empty()) {
+                task = queues[worker].tasks.back();
+                queues[worker].tasks.pop_back();
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i < queues.size(); ++i) {
+            Queue& victim = queues[(worker + i) % queues.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    explicit SortTaskPool(unsigned workers) : queues(workers) {}
+
+    void push(unsigned worker, Task task) {
+        pending.fetch_add(1);
+        std::lock_guard<std::mutex> guard(queues[worker].lock);
+        queues[worker].tasks.push_back(task);
+    }
+
+    // Process(worker, task) moze dodawac nowe zadania przez push(worker, ...).
+    template <typename Process>
+    void run(const Process& process) {
+        runParallel(static_cast<unsigned>(queues.size()), [&](unsigned worker) {
+            Task task;
+            while (!failed.load()) {
+                if (take(worker, task)) {
+                    try {
+                        process(worker, task);
+                    }
+                    catch (...) {
+                        failed.store(true);
+                        throw;
+                    }
+                    pending.fetch_sub(1);
+                }
+                else if (pending.load() == 0) {
+                    return;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+};
+
+// Kubelki wieksze od liscia staja sie kolejnymi zadaniami; kubelki rownych kluczy sa gotowe.
+template <typename E, typename Compare>
+void pushSampleSortBuckets(SortTaskPool& pool, unsigned worker, std::size_t begin, const std::vector<std::size_t>& bounds,
+                           E* arr, const Compare& less) {
+    for (std::size_t b = 0; b + 1 < bounds.size(); ++b) {
+        const std::size_t size = bounds[b + 1] - bounds[b];
+        if (size < 2 || SampleSortClassifier<E, Compare>::isEqualityBucket(b)) continue;
+        if (size <= parallelIntroSortLeafSize) introSort(arr + begin + bounds[b], size, less);
+        else pool.push(worker, { begin + bounds[b], size });
+    }
+}
+
+// Kroki podzialu dla zakresow wiekszych niz 1/threads calosci wykonuja wszystkie watki razem.
+template <typename E, typename Compare>
+void parallelIntroSort_partition(E* arr, std::size_t begin, std::size_t size, const Compare& less,
+                                 std::vector<SampleSortThreadData<E>>& data, std::size_t parallelCutoff,
+                                 std::vector<SortTaskPool::Task>& tasks) {
+    SampleSortStep<E, Compare> step(arr + begin, size, less, data.data(), static_cast<unsigned>(data.size()));
+    const std::vector<std::size_t> bounds = step.run();
+
+    for (std::size_t b = 0; b + 1 < bounds.size(); ++b) {
+        const std::size_t bucketSize = bounds[b + 1] - bounds[b];
+        if (bucketSize < 2 || SampleSortClassifier<E, Compare>::isEqualityBucket(b)) continue;
+        if (bucketSize > parallelCutoff) {
+            parallelIntroSort_partition(arr, begin + bounds[b], bucketSize, less, data, parallelCutoff, tasks);
+        }
+        else {
+            tasks.push_back({ begin + bounds[b], bucketSize });
+        }
+    }
+}
+
+// Rownolegly, niestabilny sample sort w miejscu (w stylu IPS4o): bezgaleziowa klasyfikacja
+// drzewem splitterow, bufory blokow na watek, permutacja blokow w miejscu i rekursja rozdzielana
+// pula z podkradaniem zadan. Dodatkowa pamiec to O(threads * kubelki * blok), niezaleznie od size;
+// zakresy do parallelIntroSortLeafSize sortuje sekwencyjny introSort.
+template <typename E, typename Compare = std::less<E>>
+void parallelIntroSort(E* arr, std::size_t size, const Compare& less = Compare{}, unsigned threads = 0) {
+    if (size <= parallelIntroSortLeafSize) {
+        introSort(arr, size, less);
+        return;
+    }
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<SampleSortThreadData<E>> data(threads);
+    std::vector<SortTaskPool::Task> tasks;
+    const std::size_t parallelCutoff = std::max(size / threads, parallelIntroSortLeafSize);
+    if (threads > 1) {
+        parallelIntroSort_partition(arr, 0, size, less, data, parallelCutoff, tasks);
+    }
+    else {
+        tasks.push_back({ 0, size });
+    }
+
+    std::sort(tasks.begin(), tasks.end(), [](const SortTaskPool::Task& a, const SortTaskPool::Task& b) {
+        return a.size > b.size;
+    });
+    SortTaskPool pool(threads);
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        pool.push(static_cast<unsigned>(i % threads), tasks[i]);
+    }
+
+    pool.run([&](unsigned worker, const SortTaskPool::Task& task) {
+        if (task.size <= parallelIntroSortLeafSize) {
+            introSort(arr + task.begin, task.size, less);
+            return;
+        }
+        SampleSortStep<E, Compare> step(arr + task.begin, task.size, less, &data[worker], 1);
+        pushSampleSortBuckets(pool, worker, task.begin, step.run(), arr, less);
+    });
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <exception>
+#include <thread>
+#include <vector>
+
+// Uruchamia task(0..threads-1), task 0 na biezacym watku. Pierwszy wyjatek jest przekazywany dalej
+// dopiero po dolaczeniu wszystkich watkow.
+template <typename Task>
+void runParallel(unsigned threads, const Task& task) {
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(threads);
+    workers.reserve(threads - 1);
+
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            try { task(t); }
+            catch (...) { errors[t] = std::current_exception(); }
+        });
+    }
+    try { task(0); }
+    catch (...) { errors[0] = std::current_exception(); }
+
+    for (auto& worker : workers) worker.join();
+    for (auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
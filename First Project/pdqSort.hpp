@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <algorithm>
+#include <utility>
+#include "quicksort.hpp"
+#include "HeapSort.hpp"
+#include "InsertionSort.hpp"
+#include "simdSort.hpp"
+
+// Zakresy mniejsze od tego progu sa od razu konczone przez smallSort.
+constexpr int pdqInsertionSortThreshold = 24;
+
+// Ile przesuniec moze wykonac partialInsertionSort zanim zrezygnuje.
+constexpr int pdqPartialInsertionLimit = 8;
+
+// Sortowanie przez wstawianie przerywane po pdqPartialInsertionLimit przesunieciach;
+// zwraca true, jesli zakres zostal posortowany.
+template <typename E, typename Compare>
+bool partialInsertionSort(E* arr, int left, int right, const Compare& less) {
+    int moves = 0;
+    for (int i = left + 1; i <= right; ++i) {
+        if (!less(arr[i], arr[i - 1])) continue;
+
+        E key = std::move(arr[i]);
+        int j = i;
+        do {
+            arr[j] = std::move(arr[j - 1]);
+            --j;
+        } while (j > left && less(key, arr[j - 1]));
+        arr[j] = std::move(key);
+
+        moves += i - j;
+        if (moves > pdqPartialInsertionLimit) return false;
+    }
+    return true;
+}
+
+// Przestawia kilka elementow zakresu, zeby rozbic wzorzec, ktory dal niezbalansowany podzial.
+template <typename E>
+void breakPatterns(E* arr, int left, int right) {
+    int size = right - left + 1;
+    if (size < pdqInsertionSortThreshold) return;
+
+    int quarter = size / 4;
+    std::swap(arr[left], arr[left + quarter]);
+    std::swap(arr[right], arr[right - quarter]);
+    if (size > AdaptivePivot::adaptivePivotThreshold) {
+        std::swap(arr[left + 1], arr[left + quarter + 1]);
+        std::swap(arr[left + 2], arr[left + quarter + 2]);
+        std::swap(arr[right - 1], arr[right - quarter - 1]);
+        std::swap(arr[right - 2], arr[right - quarter - 2]);
+    }
+}
+
+// Podzial jak w BlockPartition, ale dodatkowo zgloszone jest, czy zakres byl juz podzielony.
+template <typename E, typename Compare>
+std::pair<int, bool> pdqPartition(E* arr, int left, int right, const Compare& less) {
+    int l = left;
+    int r = right - 1;
+    while (l <= r && !less(arr[right], arr[l])) ++l;
+    while (r >= l && less(arr[right], arr[r])) --r;
+
+    bool alreadyPartitioned = l > r;
+    return { BlockPartition::partitionRange(arr, l, r, right, less), alreadyPartitioned };
+}
+
+// leftmost == false oznacza, ze arr[left - 1] jest wczesniejszym pivotem nie wiekszym od
+// zadnego elementu zakresu - dzieki temu serie rownych kluczy sa odcinane w jednym podziale.
+template <typename Pivot, typename E, typename Compare>
+void pdqSort_recursive(E* arr, int left, int right, const Compare& less, int badAllowed, bool leftmost) {
+    while (true) {
+        int size = right - left + 1;
+        if (size < pdqInsertionSortThreshold) {
+            if (size > 1) smallSort(arr, left, right, less);
+            return;
+        }
+
+        int pivotIndex = Pivot::select(arr, left, right, less);
+        std::swap(arr[pivotIndex], arr[right]);
+
+        if (!leftmost && !less(arr[left - 1], arr[right])) {
+            int p = HoarePartition::partition(arr, left, right, less);
+            left = p + 1;
+            continue;
+        }
+
+        std::pair<int, bool> result = pdqPartition(arr, left, right, less);
+        int p = result.first;
+        int leftSize = p - left;
+        int rightSize = right - p;
+        bool highlyUnbalanced = leftSize < size / 8 || rightSize < size / 8;
+
+        if (highlyUnbalanced) {
+            if (--badAllowed == 0) {
+                heapSort(arr + left, static_cast<std::size_t>(size), less);
+                return;
+            }
+            breakPatterns(arr, left, p - 1);
+            breakPatterns(arr, p + 1, right);
+        }
+        else if (result.second &&
+                 partialInsertionSort(arr, left, p - 1, less) &&
+                 partialInsertionSort(arr, p + 1, right, less)) {
+            return;
+        }
+
+        pdqSort_recursive<Pivot>(arr, left, p - 1, less, badAllowed, leftmost);
+        left = p + 1;
+        leftmost = false;
+    }
+}
+
+// Pattern-defeating quicksort: prawie posortowane wejscia koncza sie w czasie bliskim liniowemu,
+// wzorce psujace pivota sa rozbijane, a po log2(n) zlych podzialach zakres konczy heapSort.
+template <typename E, typename Compare = std::less<E>, typename Pivot = AdaptivePivot>
+void pdqSort(E* arr, std::size_t size, const Compare& less = Compare{}) {
+    if (size < 2) return;
+
+    int badAllowed = 1;
+    for (std::size_t n = size; n > 1; n >>= 1) ++badAllowed;
+    pdqSort_recursive<Pivot>(arr, 0, static_cast<int>(size) - 1, less, badAllowed, true);
+}
@@ -3,40 +3,382 @@
 #include <functional>
 #include <random>
 #include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "simdSort.hpp"
+#include "sortInstrumentation.hpp"
+
+// Polityki partycjonowania: dziela arr[left..right-1] wzgledem pivota lezacego w arr[right]
+// (elementy nie wieksze od pivota na lewo) i zwracaja docelowa pozycje pivota.
+struct HoarePartition {
+    // Petla Hoare'a na arr[l..r]; wszystko przed l jest juz <= pivot, wszystko za r > pivot.
+    template <typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+    static int partitionRange(E* arr, int l, int r, int right, const Compare& less) {
+        const E& pivot = arr[right];
+        while (l <= r) {
+            while (l <= r && !less(pivot, arr[l])) l++;
+            while (r >= l && less(pivot, arr[r])) r--;
+            if (l < r) countedSwap<Instrumentation>(arr[l], arr[r]);
+        }
+        countedSwap<Instrumentation>(arr[l], arr[right]);
+        return l;
+    }
+
+    template <typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+    static int partition(E* arr, int left, int right, const Compare& less) {
+        return partitionRange<Instrumentation>(arr, left, right - 1, right, less);
+    }
+};
+
+// BlockQuicksort: wyniki porownan trafiaja do buforow przesuniec bez skokow warunkowych,
+// a zamiany robione sa parami z obu buforow. Koncowke dokancza petla Hoare'a.
+// Jak HoarePartition odsyla wszystkie klucze rowne pivotowi na lewo, wiec przy malo roznych
+// kluczach podzialy sa skrajnie nierowne i sortowanie jest kwadratowe; dlatego introSort
+// uzywa jej w AdaptiveThreeWayPartition<BlockPartition>.
+struct BlockPartition {
+    static constexpr int blockSize = 64;
+
+    template <typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+    static int partitionRange(E* arr, int l, int r, int right, const Compare& less) {
+        const E& pivot = arr[right];
+        unsigned char offsetsL[blockSize];
+        unsigned char offsetsR[blockSize];
+        int numL = 0, numR = 0, startL = 0, startR = 0;
+
+        while (r - l + 1 > 2 * blockSize) {
+            if (numL == 0) {
+                startL = 0;
+                for (int i = 0; i < blockSize; ++i) {
+                    offsetsL[numL] = static_cast<unsigned char>(i);
+                    numL += less(pivot, arr[l + i]);
+                }
+            }
+            if (numR == 0) {
+                startR = 0;
+                for (int i = 0; i < blockSize; ++i) {
+                    offsetsR[numR] = static_cast<unsigned char>(i);
+                    numR += !less(pivot, arr[r - i]);
+                }
+            }
+
+            int num = std::min(numL, numR);
+            for (int i = 0; i < num; ++i) {
+                countedSwap<Instrumentation>(arr[l + offsetsL[startL + i]], arr[r - offsetsR[startR + i]]);
+            }
+            numL -= num;
+            numR -= num;
+            startL += num;
+            startR += num;
+            if (numL == 0) l += blockSize;
+            if (numR == 0) r -= blockSize;
+        }
+
+        return HoarePartition::partitionRange<Instrumentation>(arr, l, r, right, less);
+    }
+
+    template <typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+    static int partition(E* arr, int left, int right, const Compare& less) {
+        return partitionRange<Instrumentation>(arr, left, right - 1, right, less);
+    }
+};
+
+// Podzakresy, ktore po podziale trzeba jeszcze posortowac; reszta elementow jest juz na miejscu.
+struct PartitionSegments {
+    int left[3];
+    int right[3];
+    int count = 0;
+
+    void add(int l, int r) {
+        left[count] = l;
+        right[count] = r;
+        ++count;
+    }
+};
+
+// Podzial Dijkstry (flaga holenderska) wzgledem pivota wybranego polityka Pivot:
+// < pivot | == pivot | > pivot. Srodek nie jest dalej sortowany, wiec przy k roznych
+// kluczach glebokosc rekursji nie przekracza k, a sortowanie dziala w O(n*k).
+struct ThreeWayPartition {
+    static constexpr bool segmented = true;
+
+    // Pivot lezy w arr[right]; zwraca przedzial [first, last] elementow mu rownych.
+    template <typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+    static std::pair<int, int> partitionEqual(E* arr, int left, int right, const Compare& less) {
+        const E& pivot = arr[right];
+        int lt = left;
+        int i = left;
+        int gt = right - 1;
+        while (i <= gt) {
+            if (less(arr[i], pivot)) countedSwap<Instrumentation>(arr[lt++], arr[i++]);
+            else if (less(pivot, arr[i])) countedSwap<Instrumentation>(arr[i], arr[gt--]);
+            else ++i;
+        }
+        countedSwap<Instrumentation>(arr[gt + 1], arr[right]);
+        return { lt, gt + 1 };
+    }
+
+    template <typename Pivot, typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+    static PartitionSegments segments(E* arr, int left, int right, const Compare& less) {
+        int pivotIndex = Pivot::select(arr, left, right, less);
+        countedSwap<Instrumentation>(arr[pivotIndex], arr[right]);
+
+        std::pair<int, int> equal = partitionEqual<Instrumentation>(arr, left, right, less);
+        PartitionSegments result;
+        result.add(left, equal.first - 1);
+        result.add(equal.second + 1, right);
+        return result;
+    }
+};
+
+// Dual-pivot quicksort Jaroslawskiego: < p1 | p1 <= x <= p2 | > p2. Pivoty to druga i czwarta
+// z pieciu posortowanych probek (polityka Pivot nie jest uzywana). Przy rownych pivotach
+// zakres dzieli sie trojdrogowo, zeby serie rownych kluczy nie psuly rekursji.
+struct DualPivotPartition {
+    static constexpr bool segmented = true;
+
+    template <typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+    static void choosePivots(E* arr, int left, int right, const Compare& less) {
+        int sixth = (right - left + 1) / 6;
+        if (sixth > 0) {
+            int mid = left + (right - left) / 2;
+            int sample[5] = { mid - 2 * sixth, mid - sixth, mid, mid + sixth, mid + 2 * sixth };
+            for (int i = 1; i < 5; ++i) {
+                for (int j = i; j > 0 && less(arr[sample[j]], arr[sample[j - 1]]); --j) {
+                    countedSwap<Instrumentation>(arr[sample[j]], arr[sample[j - 1]]);
+                }
+            }
+            countedSwap<Instrumentation>(arr[sample[1]], arr[left]);
+            countedSwap<Instrumentation>(arr[sample[3]], arr[right]);
+        }
+        if (less(arr[right], arr[left])) countedSwap<Instrumentation>(arr[left], arr[right]);
+    }
+
+    template <typename Pivot, typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+    static PartitionSegments segments(E* arr, int left, int right, const Compare& less) {
+        choosePivots<Instrumentation>(arr, left, right, less);
+
+        PartitionSegments result;
+        if (!less(arr[left], arr[right])) {
+            std::pair<int, int> equal = ThreeWayPartition::partitionEqual<Instrumentation>(arr, left, right, less);
+            result.add(left, equal.first - 1);
+            result.add(equal.second + 1, right);
+            return result;
+        }
+
+        const E& p1 = arr[left];
+        const E& p2 = arr[right];
+        int lt = left + 1;
+        int gt = right - 1;
+        for (int k = lt; k <= gt; ++k) {
+            if (less(arr[k], p1)) {
+                countedSwap<Instrumentation>(arr[k], arr[lt++]);
+            }
+            else if (less(p2, arr[k])) {
+                while (k < gt && less(p2, arr[gt])) --gt;
+                countedSwap<Instrumentation>(arr[k], arr[gt--]);
+                if (less(arr[k], p1)) countedSwap<Instrumentation>(arr[k], arr[lt++]);
+            }
+        }
+        --lt;
+        ++gt;
+        countedSwap<Instrumentation>(arr[left], arr[lt]);
+        countedSwap<Instrumentation>(arr[right], arr[gt]);
+
+        result.add(left, lt - 1);
+        result.add(lt + 1, gt - 1);
+        result.add(gt + 1, right);
+        return result;
+    }
+};
+
+// Polityka z wykrywaniem duplikatow: jesli pivot jest rowny ktorejs z pieciu probek zakresu,
+// zakres dzieli sie trojdrogowo, w przeciwnym razie dwudrogowa polityka TwoWay.
+// Koszt wykrycia to piec porownan na podzial.
+template <typename TwoWay = BlockPartition>
+struct AdaptiveThreeWayPartition {
+    static constexpr bool segmented = true;
+
+    template <typename E, typename Compare>
+    static bool hasDuplicates(E* arr, int left, int right, const Compare& less) {
+        const E& pivot = arr[right];
+        int quarter = (right - left) / 4;
+        int probes[5] = { left, left + quarter, left + 2 * quarter, right - quarter, right - 1 };
+        for (int probe : probes) {
+            if (probe >= left && probe < right && !less(arr[probe], pivot) && !less(pivot, arr[probe])) return true;
+        }
+        return false;
+    }
+
+    template <typename Pivot, typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+    static PartitionSegments segments(E* arr, int left, int right, const Compare& less) {
+        int pivotIndex = Pivot::select(arr, left, right, less);
+        countedSwap<Instrumentation>(arr[pivotIndex], arr[right]);
+
+        PartitionSegments result;
+        if (hasDuplicates(arr, left, right, less)) {
+            std::pair<int, int> equal = ThreeWayPartition::partitionEqual<Instrumentation>(arr, left, right, less);
+            result.add(left, equal.first - 1);
+            result.add(equal.second + 1, right);
+        }
+        else {
+            int p = TwoWay::template partition<Instrumentation>(arr, left, right, less);
+            result.add(left, p - 1);
+            result.add(p + 1, right);
+        }
+        return result;
+    }
+};
+
+// Rozmiar podzielonego zakresu arr[left..right] i jego najwiekszego podzakresu trafiaja do licznikow.
+template <typename Instrumentation>
+void recordPartition(const PartitionSegments& parts, int left, int right) {
+    if constexpr (Instrumentation::enabled) {
+        int largest = 0;
+        for (int i = 0; i < parts.count; ++i) {
+            largest = std::max(largest, parts.right[i] - parts.left[i] + 1);
+        }
+        Instrumentation::partition(static_cast<std::size_t>(right - left + 1), static_cast<std::size_t>(largest));
+    }
+}
+
+template <typename Partition, typename = void>
+struct isSegmentedPartition : std::false_type {};
+
+template <typename Partition>
+struct isSegmentedPartition<Partition, std::void_t<decltype(Partition::segmented)>> : std::true_type {};
 
 template <typename E, typename Compare>
-void quickSortStep(E* arr, int left, int right, const Compare& less, std::size_t* depthLimit = nullptr) {
-    if (left >= right) return;
+int medianOf3(E* arr, int a, int b, int c, const Compare& less) {
+    if (less(arr[a], arr[b])) {
+        if (less(arr[b], arr[c])) return b;
+        return less(arr[a], arr[c]) ? c : a;
+    }
+    if (less(arr[a], arr[c])) return a;
+    return less(arr[b], arr[c]) ? c : b;
+}
+
+// Polityki wyboru pivota: zwracaja indeks pivota z arr[left..right] bez przestawiania elementow.
+struct RandomPivot {
+    // Jeden generator na watek zamiast std::random_device przy kazdym podziale.
+    static std::mt19937& generator() {
+        thread_local std::mt19937 engine(std::random_device{}());
+        return engine;
+    }
+
+    template <typename E, typename Compare>
+    static int select(E*, int left, int right, const Compare&) {
+        std::uniform_int_distribution<int> dist(left, right);
+        return dist(generator());
+    }
+};
 
-    
-    if (depthLimit) {
-        if (*depthLimit == 0) return; 
-        --(*depthLimit);
+struct MedianOf3Pivot {
+    template <typename E, typename Compare>
+    static int select(E* arr, int left, int right, const Compare& less) {
+        return medianOf3(arr, left, left + (right - left) / 2, right, less);
     }
+};
+
+// Pseudomediana Tukeya: mediana z median trzech rownomiernie rozlozonych trojek.
+struct NintherPivot {
+    template <typename E, typename Compare>
+    static int select(E* arr, int left, int right, const Compare& less) {
+        int step = (right - left) / 8;
+        if (step == 0) return MedianOf3Pivot::select(arr, left, right, less);
 
-    std::mt19937 generator(std::random_device{}());
-    std::uniform_int_distribution<int> dist(left, right);
-    int pivotIndex = dist(generator);
-    std::swap(arr[pivotIndex], arr[right]);
+        int mid = left + (right - left) / 2;
+        int a = medianOf3(arr, left, left + step, left + 2 * step, less);
+        int b = medianOf3(arr, mid - step, mid, mid + step, less);
+        int c = medianOf3(arr, right - 2 * step, right - step, right, less);
+        return medianOf3(arr, a, b, c, less);
+    }
+};
 
-    E pivot = arr[right];
-    int l = left;
-    int r = right - 1;
+// Mediana z trzech dla malych zakresow, ninther od adaptivePivotThreshold elementow.
+// Probki mediany leza w cwiartkach, a nie na koncach: podzial zostawia na koncach podzakresow
+// pivot i elementy skrajne, wiec np. odwrocone wejscie przy probkach z koncow wyczerpywalo
+// limit glebokosci introSort w prawie kazdym malym podzakresie.
+struct AdaptivePivot {
+    static constexpr int adaptivePivotThreshold = 128;
 
-    while (l <= r) {
-        while (l <= r && !less(pivot, arr[l])) l++;
-        while (r >= l && less(pivot, arr[r])) r--;
-        if (l < r) std::swap(arr[l], arr[r]);
+    template <typename E, typename Compare>
+    static int select(E* arr, int left, int right, const Compare& less) {
+        if (right - left + 1 < adaptivePivotThreshold) {
+            int quarter = (right - left) / 4;
+            return medianOf3(arr, left + quarter, left + (right - left) / 2, right - quarter, less);
+        }
+        return NintherPivot::select(arr, left, right, less);
     }
+};
+
+// Wybiera pivota, przenosi go na koniec zakresu i partycjonuje; zwraca pozycje pivota.
+template <typename Partition = HoarePartition, typename Pivot = RandomPivot, typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+int quickSortPartition(E* arr, int left, int right, const Compare& less) {
+    int pivotIndex = Pivot::select(arr, left, right, less);
+    countedSwap<Instrumentation>(arr[pivotIndex], arr[right]);
 
-    std::swap(arr[l], arr[right]);
+    return Partition::template partition<Instrumentation>(arr, left, right, less);
+}
 
-    if (l > 0) quickSortStep(arr, left, l - 1, less, depthLimit);
-    quickSortStep(arr, l + 1, right, less, depthLimit);
+// Jeden krok podzialu dowolna polityka: dwudrogowe daja dwa podzakresy wokol pivota,
+// wielodrogowe (segmented) zwracaja podzakresy same.
+template <typename Partition = HoarePartition, typename Pivot = RandomPivot, typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+PartitionSegments quickSortSegments(E* arr, int left, int right, const Compare& less) {
+    if constexpr (isSegmentedPartition<Partition>::value) {
+        return Partition::template segments<Pivot, Instrumentation>(arr, left, right, less);
+    }
+    else {
+        int p = quickSortPartition<Partition, Pivot, Instrumentation>(arr, left, right, less);
+        PartitionSegments result;
+        result.add(left, p - 1);
+        result.add(p + 1, right);
+        return result;
+    }
+}
+
+// Instrumentation liczy porownania, zamiany, glebokosc rekursji i niezrownowazenie podzialow.
+// Rekurencja idzie w mniejsze podzakresy, najwiekszy jest obslugiwany w petli, wiec stos ma
+// glebokosc O(log n) rowniez przy skrajnie nierownych podzialach.
+template <typename Partition = AdaptiveThreeWayPartition<HoarePartition>, typename Pivot = RandomPivot, typename Instrumentation = NoInstrumentation, typename E, typename Compare>
+void quickSortStep(E* arr, int left, int right, const Compare& less, std::size_t* depthLimit = nullptr, std::size_t depth = 0) {
+    if (left >= right) return;
+    if constexpr (needsCountingCompare<Instrumentation, Compare>) {
+        using Counting = CountingCompare<Compare, Instrumentation>;
+        quickSortStep<Partition, Pivot, Instrumentation>(arr, left, right, Counting{ less }, depthLimit, depth);
+        return;
+    }
+    while (left < right) {
+        Instrumentation::depth(depth);
+        if (useSimdSmallSort<E, Compare>(static_cast<std::size_t>(right - left + 1))) {
+            smallSort(arr, left, right, less);
+            return;
+        }
+
+        if (depthLimit) {
+            if (*depthLimit == 0) return;
+            --(*depthLimit);
+        }
+        ++depth;
+
+        PartitionSegments parts = quickSortSegments<Partition, Pivot, Instrumentation>(arr, left, right, less);
+        recordPartition<Instrumentation>(parts, left, right);
+
+        int largest = 0;
+        for (int i = 1; i < parts.count; ++i) {
+            if (parts.right[i] - parts.left[i] > parts.right[largest] - parts.left[largest]) largest = i;
+        }
+        for (int i = 0; i < parts.count; ++i) {
+            if (i != largest) quickSortStep<Partition, Pivot, Instrumentation>(arr, parts.left[i], parts.right[i], less, depthLimit, depth);
+        }
+        left = parts.left[largest];
+        right = parts.right[largest];
+    }
 }
 
-template <typename E, typename Compare = std::less<E>>
+// Domyslnie petla Hoare'a z wykrywaniem duplikatow (AdaptiveThreeWayPartition); tryby
+// wybiera sie parametrem Partition, np. ThreeWayPartition albo DualPivotPartition.
+template <typename E, typename Compare = std::less<E>, typename Partition = AdaptiveThreeWayPartition<HoarePartition>, typename Pivot = RandomPivot, typename Instrumentation = NoInstrumentation>
 void quickSort(E* arr, int size, const Compare& less = Compare{}) {
     if (size <= 1) return;
-    quickSortStep(arr, 0, size - 1, less);
+    quickSortStep<Partition, Pivot, Instrumentation>(arr, 0, size - 1, less);
 }
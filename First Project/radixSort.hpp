@@ -0,0 +1,151 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "InsertionSort.hpp"
+
+// Od tego rozmiaru introSort dla kluczy calkowitych i std::less przechodzi na americanFlagSort,
+// ktory sortuje w miejscu; LSD z buforem O(n) wywoluje sie jawnie przez radixSort.
+constexpr std::size_t radixSortThreshold = 4096;
+
+// Kubelki MSD mniejsze niz ten prog sa konczone sortowaniem przez wstawianie.
+constexpr std::size_t americanFlagSortCutoff = 32;
+
+template <typename E>
+constexpr bool isRadixSortable = std::is_integral<E>::value && !std::is_same<E, bool>::value;
+
+// Czy introSort<E, Compare> moze oddac tablice do sortowania pozycyjnego bez zmiany wyniku.
+template <typename E, typename Compare>
+constexpr bool isRadixDispatchable = isRadixSortable<E> &&
+    (std::is_same<Compare, std::less<E>>::value || std::is_same<Compare, std::less<>>::value);
+
+// Klucz bez znaku o tym samym porzadku co E: dla typow ze znakiem odwracany jest bit znaku.
+template <typename E>
+typename std::make_unsigned<E>::type radixKey(E value) {
+    using U = typename std::make_unsigned<E>::type;
+    U key = static_cast<U>(value);
+    if (std::is_signed<E>::value) {
+        key ^= U(1) << (sizeof(U) * 8 - 1);
+    }
+    return key;
+}
+
+// LSD: wszystkie histogramy liczone w jednym przebiegu, potem przebiegi przerzucaja dane
+// miedzy arr a buffer. Przebiegi, w ktorych wszystkie elementy maja te sama cyfre, sa pomijane.
+template <unsigned DigitBits, typename E>
+void lsdRadixSort(E* arr, E* buffer, std::size_t size) {
+    static_assert(isRadixSortable<E>, "lsdRadixSort wymaga typu calkowitego");
+    static_assert(DigitBits >= 1 && DigitBits <= 16, "nieobslugiwana szerokosc cyfry");
+
+    constexpr unsigned keyBits = sizeof(E) * 8;
+    constexpr unsigned passes = (keyBits + DigitBits - 1) / DigitBits;
+    constexpr std::size_t radix = std::size_t(1) << DigitBits;
+    constexpr std::size_t mask = radix - 1;
+
+    std::vector<std::size_t> counts(passes * radix, 0);
+    for (std::size_t i = 0; i < size; ++i) {
+        auto key = radixKey(arr[i]);
+        for (unsigned p = 0; p < passes; ++p) {
+            ++counts[p * radix + ((key >> (p * DigitBits)) & mask)];
+        }
+    }
+
+    E* src = arr;
+    E* dst = buffer;
+    for (unsigned p = 0; p < passes; ++p) {
+        std::size_t* count = counts.data() + p * radix;
+        unsigned shift = p * DigitBits;
+        if (count[(radixKey(src[0]) >> shift) & mask] == size) continue;
+
+        std::size_t sum = 0;
+        for (std::size_t d = 0; d < radix; ++d) {
+            std::size_t c = count[d];
+            count[d] = sum;
+            sum += c;
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+            dst[count[(radixKey(src[i]) >> shift) & mask]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != arr) {
+        std::copy(src, src + size, arr);
+    }
+}
+
+template <unsigned DigitBits = 8, typename E>
+void lsdRadixSort(E* arr, std::size_t size) {
+    if (size < 2) return;
+
+    E* buffer = new (std::nothrow) E[size];
+    if (!buffer) {
+        throw std::bad_alloc();
+    }
+    lsdRadixSort<DigitBits>(arr, buffer, size);
+    delete[] buffer;
+}
+
+// American flag sort: permutacja w miejscu po 8-bitowych cyfrach od najstarszej.
+template <typename E>
+void americanFlagSort_recursive(E* arr, std::size_t size, int shift) {
+    if (size < americanFlagSortCutoff) {
+        if (size > 1) insertionSort(arr, 0, size - 1, std::less<E>{});
+        return;
+    }
+
+    std::size_t count[256] = {};
+    for (std::size_t i = 0; i < size; ++i) {
+        ++count[(radixKey(arr[i]) >> shift) & 0xFF];
+    }
+
+    std::size_t head[256];
+    std::size_t tail[256];
+    std::size_t sum = 0;
+    for (int d = 0; d < 256; ++d) {
+        head[d] = sum;
+        sum += count[d];
+        tail[d] = sum;
+    }
+
+    for (int d = 0; d < 256; ++d) {
+        while (head[d] < tail[d]) {
+            E value = arr[head[d]];
+            int digit = static_cast<int>((radixKey(value) >> shift) & 0xFF);
+            while (digit != d) {
+                std::swap(value, arr[head[digit]++]);
+                digit = static_cast<int>((radixKey(value) >> shift) & 0xFF);
+            }
+            arr[head[d]++] = value;
+        }
+    }
+
+    if (shift == 0) return;
+    std::size_t start = 0;
+    for (int d = 0; d < 256; ++d) {
+        americanFlagSort_recursive(arr + start, count[d], shift - 8);
+        start += count[d];
+    }
+}
+
+template <typename E>
+void americanFlagSort(E* arr, std::size_t size) {
+    static_assert(isRadixSortable<E>, "americanFlagSort wymaga typu calkowitego");
+    americanFlagSort_recursive(arr, size, static_cast<int>(sizeof(E) * 8) - 8);
+}
+
+// Sortowanie rosnace kluczy calkowitych; 11-bitowe cyfry oplacaja sie dopiero na duzych tablicach.
+template <typename E>
+void radixSort(E* arr, std::size_t size) {
+    static_assert(isRadixSortable<E>, "radixSort wymaga typu calkowitego");
+    if (sizeof(E) >= 4 && size >= (std::size_t(1) << 16)) {
+        lsdRadixSort<11>(arr, size);
+    }
+    else {
+        lsdRadixSort<8>(arr, size);
+    }
+}
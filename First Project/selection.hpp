@@ -0,0 +1,169 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "quicksort.hpp"
+#include "HeapSort.hpp"
+#include "IntroSort.hpp"
+#include "simdSort.hpp"
+
+// Zakresy tej wielkosci introSelect konczy sortowaniem.
+constexpr int introSelectThreshold = 16;
+
+// partialSort wybiera ograniczony kopiec, gdy k <= size / partialSortHeapRatio.
+constexpr std::size_t partialSortHeapRatio = 32;
+
+template <typename E, typename Compare>
+void medianOfMediansSelect(E* arr, int left, int right, int k, const Compare& less);
+
+// Mediana median piatek: mediany grup sa zbierane na poczatku zakresu, a ich mediana wybierana
+// deterministycznie, co daje gwarantowany podzial 30/70. W odroznieniu od pozostalych polityk
+// przestawia elementy zakresu (partycjonowanie i tak nastepuje zaraz potem).
+struct MedianOfMediansPivot {
+    template <typename E, typename Compare>
+    static int select(E* arr, int left, int right, const Compare& less) {
+        int size = right - left + 1;
+        if (size <= 5) {
+            insertionSort(arr, left, right, less);
+            return left + (right - left) / 2;
+        }
+
+        int groups = 0;
+        for (int first = left; first <= right; first += 5) {
+            int last = std::min(first + 4, right);
+            insertionSort(arr, first, last, less);
+            std::swap(arr[left + groups], arr[first + (last - first) / 2]);
+            ++groups;
+        }
+
+        int median = left + (groups - 1) / 2;
+        medianOfMediansSelect(arr, left, left + groups - 1, median, less);
+        return median;
+    }
+};
+
+// Wybor w pesymistycznym czasie liniowym: pivot z mediany median, podzial trojdrogowy.
+template <typename E, typename Compare>
+void medianOfMediansSelect(E* arr, int left, int right, int k, const Compare& less) {
+    while (right - left + 1 > introSelectThreshold) {
+        PartitionSegments parts = quickSortSegments<ThreeWayPartition, MedianOfMediansPivot>(arr, left, right, less);
+        if (k <= parts.right[0]) right = parts.right[0];
+        else if (k >= parts.left[1]) left = parts.left[1];
+        else return;
+    }
+    insertionSort(arr, left, right, less);
+}
+
+// Quickselect na podzialach quickSortStep; po 2*log2(n) krokach bez wyraznego postepu
+// pozostaly zakres konczy wybor mediana median, wiec czas jest liniowy takze pesymistycznie.
+template <typename Partition, typename Pivot, typename E, typename Compare>
+void introSelect_recursive(E* arr, int left, int right, int k, const Compare& less, std::size_t depthLimit) {
+    while (right - left + 1 > introSelectThreshold) {
+        if (depthLimit == 0) {
+            medianOfMediansSelect(arr, left, right, k, less);
+            return;
+        }
+        --depthLimit;
+
+        PartitionSegments parts = quickSortSegments<Partition, Pivot>(arr, left, right, less);
+        int next = -1;
+        for (int i = 0; i < parts.count; ++i) {
+            if (parts.left[i] <= k && k <= parts.right[i]) next = i;
+        }
+        if (next < 0) return;
+        left = parts.left[next];
+        right = parts.right[next];
+    }
+    if (left < right) smallSort(arr, left, right, less);
+}
+
+// Ustawia na pozycji k element, ktory stalby tam po posortowaniu; elementy przed k nie sa
+// wieksze od niego, a elementy za k nie sa mniejsze (jak std::nth_element).
+template <typename E, typename Compare = std::less<E>, typename Partition = AdaptiveThreeWayPartition<BlockPartition>, typename Pivot = AdaptivePivot>
+void introSelect(E* arr, std::size_t size, std::size_t k, const Compare& less = Compare{}) {
+    if (size < 2 || k >= size) return;
+
+    std::size_t depthLimit = 2 * static_cast<std::size_t>(std::log2(size));
+    introSelect_recursive<Partition, Pivot>(arr, 0, static_cast<int>(size) - 1, static_cast<int>(k), less, depthLimit);
+}
+
+// Ograniczony kopiec: arr[0..k) jest kopcem typu max k najmniejszych dotad elementow, kazdy
+// mniejszy od korzenia element reszty zastepuje korzen. Na koniec kopiec jest sortowany.
+template <typename E, typename Compare>
+void partialSortWithHeap(E* arr, std::size_t size, std::size_t k, const Compare& less) {
+    makeHeap<heapSortArity>(arr, k, less);
+    for (std::size_t i = k; i < size; ++i) {
+        if (less(arr[i], arr[0])) {
+            E value = std::move(arr[i]);
+            arr[i] = std::move(arr[0]);
+            heapSiftDown<heapSortArity>(arr, k, 0, std::move(value), less);
+        }
+    }
+    for (std::size_t i = k; i > 1; --i) {
+        popHeap<heapSortArity>(arr, i, less);
+    }
+}
+
+// Sortuje k najmniejszych elementow do arr[0..k); kolejnosc reszty jest nieokreslona.
+// Male k - jeden przebieg z ograniczonym kopcem, wieksze - introSelect i introSort prefiksu.
+template <typename E, typename Compare = std::less<E>>
+void partialSort(E* arr, std::size_t size, std::size_t k, const Compare& less = Compare{}) {
+    k = std::min(k, size);
+    if (k == 0) return;
+
+    if (k <= size / partialSortHeapRatio) {
+        partialSortWithHeap(arr, size, k, less);
+        return;
+    }
+    if (k < size) introSelect(arr, size, k, less);
+    introSort(arr, k, less);
+}
+
+// Strumieniowe k najmniejszych (wedlug less; dla najwiekszych std::greater) w pamieci O(k).
+template <typename E, typename Compare = std::less<E>>
+class TopK {
+    Heap<E, Compare> heap;
+    std::size_t k;
+    Compare less;
+
+public:
+    explicit TopK(std::size_t k, const Compare& less = Compare{}) : heap(less), k(k), less(less) {
+        heap.reserve(k);
+    }
+
+    std::size_t size() const { return heap.size(); }
+
+    void push(const E& value) {
+        if (heap.size() < k) {
+            heap.push(value);
+        }
+        else if (k > 0 && less(value, heap.top())) {
+            heap.replaceTop(value);
+        }
+    }
+
+    template <typename Iterator>
+    void push(Iterator first, Iterator last) {
+        for (; first != last; ++first) push(*first);
+    }
+
+    // Wynik rosnaco wedlug less; obiekt zostaje pusty.
+    std::vector<E> take() {
+        std::vector<E> result(heap.size());
+        for (std::size_t i = result.size(); i > 0; --i) {
+            result[i - 1] = heap.pop();
+        }
+        return result;
+    }
+};
+
+// k najmniejszych elementow tablicy, posortowanych, bez modyfikowania wejscia.
+template <typename E, typename Compare = std::less<E>>
+std::vector<E> topK(const E* arr, std::size_t size, std::size_t k, const Compare& less = Compare{}) {
+    TopK<E, Compare> selector(k, less);
+    selector.push(arr, arr + size);
+    return selector.take();
+}
@@ -0,0 +1,241 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "simdSort.hpp"
+
+// Dokancza scalanie skalarnie: tail (posortowany, nie mniejszy od niczego, co juz wyszlo)
+// oraz reszty obu serii.
+template <typename T>
+void mergeTails(const T* t, const T* tEnd, const T* a, const T* aEnd, const T* b, const T* bEnd, T* out) {
+    while (t != tEnd) {
+        if (a != aEnd && *a < *t && (b == bEnd || !(*b < *a))) *out++ = *a++;
+        else if (b != bEnd && *b < *t) *out++ = *b++;
+        else *out++ = *t++;
+    }
+    while (a != aEnd && b != bEnd) {
+        if (*b < *a) *out++ = *b++;
+        else *out++ = *a++;
+    }
+    while (a != aEnd) *out++ = *a++;
+    while (b != bEnd) *out++ = *b++;
+}
+
+#if SIMD_SORT_X86
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SIMD_MERGE_INLINE __forceinline
+#else
+#define SIMD_MERGE_INLINE inline __attribute__((always_inline))
+#endif
+
+// Kazda struktura scala dwa posortowane wektory siecia bitoniczna: drugi jest odwracany,
+// min/max daje dwie polowki bitoniczne, a trzy (cztery) kroki wewnatrz rejestru je porzadkuja.
+// Po merge2 `lo` zawiera najmniejsze, a `hi` najwieksze elementy obu wektorow.
+struct MergeAvx2Int32 {
+    using T = std::int32_t;
+    using V = __m256i;
+    static constexpr std::size_t lanes = 8;
+
+    SIMD_SORT_AVX2 static V load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const V*>(p)); }
+    SIMD_SORT_AVX2 static void store(T* p, V v) { _mm256_storeu_si256(reinterpret_cast<V*>(p), v); }
+
+    SIMD_SORT_AVX2 static V clean(V v) {
+        V p = _mm256_permute2x128_si256(v, v, 1);
+        v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xF0);
+        p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+        v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xCC);
+        p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xAA);
+    }
+
+    SIMD_SORT_AVX2 static void merge2(V& lo, V& hi) {
+        V reversed = _mm256_permutevar8x32_epi32(hi, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+        V mn = _mm256_min_epi32(lo, reversed);
+        V mx = _mm256_max_epi32(lo, reversed);
+        lo = clean(mn);
+        hi = clean(mx);
+    }
+};
+
+struct MergeAvx2Int64 {
+    using T = std::int64_t;
+    using V = __m256i;
+    static constexpr std::size_t lanes = 4;
+
+    SIMD_SORT_AVX2 static V load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const V*>(p)); }
+    SIMD_SORT_AVX2 static void store(T* p, V v) { _mm256_storeu_si256(reinterpret_cast<V*>(p), v); }
+
+    SIMD_SORT_AVX2 static V minv(V a, V b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+    SIMD_SORT_AVX2 static V maxv(V a, V b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+
+    SIMD_SORT_AVX2 static V clean(V v) {
+        V p = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 0, 3, 2));
+        v = _mm256_blend_epi32(minv(v, p), maxv(v, p), 0xF0);
+        p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+        return _mm256_blend_epi32(minv(v, p), maxv(v, p), 0xCC);
+    }
+
+    SIMD_SORT_AVX2 static void merge2(V& lo, V& hi) {
+        V reversed = _mm256_permute4x64_epi64(hi, _MM_SHUFFLE(0, 1, 2, 3));
+        V mn = minv(lo, reversed);
+        V mx = maxv(lo, reversed);
+        lo = clean(mn);
+        hi = clean(mx);
+    }
+};
+
+// Wersje AVX-512 uzywaja wariantow maskz z pelna maska: wynik jest ten sam, a GCC 12 nie
+// zglasza falszywego -Wuninitialized z _mm512_undefined_epi32 w naglowkach intrinsics.
+struct MergeAvx512Int32 {
+    using T = std::int32_t;
+    using V = __m512i;
+    static constexpr std::size_t lanes = 16;
+
+    SIMD_SORT_AVX512 static V load(const T* p) { return _mm512_loadu_si512(p); }
+    SIMD_SORT_AVX512 static void store(T* p, V v) { _mm512_storeu_si512(p, v); }
+
+    SIMD_SORT_AVX512 static V step(V v, V permutation, __mmask16 upper) {
+        V p = _mm512_maskz_permutexvar_epi32(0xFFFF, permutation, v);
+        return _mm512_mask_blend_epi32(upper, _mm512_maskz_min_epi32(0xFFFF, v, p), _mm512_maskz_max_epi32(0xFFFF, v, p));
+    }
+
+    SIMD_SORT_AVX512 static V clean(V v) {
+        v = step(v, _mm512_setr_epi32(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7), 0xFF00);
+        v = step(v, _mm512_setr_epi32(4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11), 0xF0F0);
+        v = step(v, _mm512_setr_epi32(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13), 0xCCCC);
+        return step(v, _mm512_setr_epi32(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14), 0xAAAA);
+    }
+
+    SIMD_SORT_AVX512 static void merge2(V& lo, V& hi) {
+        V reversed = _mm512_maskz_permutexvar_epi32(0xFFFF, _mm512_setr_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0), hi);
+        V mn = _mm512_maskz_min_epi32(0xFFFF, lo, reversed);
+        V mx = _mm512_maskz_max_epi32(0xFFFF, lo, reversed);
+        lo = clean(mn);
+        hi = clean(mx);
+    }
+};
+
+struct MergeAvx512Int64 {
+    using T = std::int64_t;
+    using V = __m512i;
+    static constexpr std::size_t lanes = 8;
+
+    SIMD_SORT_AVX512 static V load(const T* p) { return _mm512_loadu_si512(p); }
+    SIMD_SORT_AVX512 static void store(T* p, V v) { _mm512_storeu_si512(p, v); }
+
+    SIMD_SORT_AVX512 static V step(V v, V permutation, __mmask8 upper) {
+        V p = _mm512_maskz_permutexvar_epi64(0xFF, permutation, v);
+        return _mm512_mask_blend_epi64(upper, _mm512_maskz_min_epi64(0xFF, v, p), _mm512_maskz_max_epi64(0xFF, v, p));
+    }
+
+    SIMD_SORT_AVX512 static V clean(V v) {
+        v = step(v, _mm512_setr_epi64(4, 5, 6, 7, 0, 1, 2, 3), 0xF0);
+        v = step(v, _mm512_setr_epi64(2, 3, 0, 1, 6, 7, 4, 5), 0xCC);
+        return step(v, _mm512_setr_epi64(1, 0, 3, 2, 5, 4, 7, 6), 0xAA);
+    }
+
+    SIMD_SORT_AVX512 static void merge2(V& lo, V& hi) {
+        V reversed = _mm512_maskz_permutexvar_epi64(0xFF, _mm512_setr_epi64(7, 6, 5, 4, 3, 2, 1, 0), hi);
+        V mn = _mm512_maskz_min_epi64(0xFF, lo, reversed);
+        V mx = _mm512_maskz_max_epi64(0xFF, lo, reversed);
+        lo = clean(mn);
+        hi = clean(mx);
+    }
+};
+
+// Petla scalania wektorowego: `hi` zawsze trzyma `lanes` najwiekszych z dotad wczytanych
+// elementow, a kolejny blok jest doczytywany z tej serii, ktorej czolo jest mniejsze.
+// Zakonczenie (mniej niz `lanes` elementow w ktorejs serii) idzie przez mergeTails.
+// Jedno cialo dla AVX2 i AVX-512: jest zawsze rozwijane w wersjach ponizej, ktore dodaja
+// tylko atrybut docelowego zestawu instrukcji, wiec operacje Ops wchodza w ich kod.
+// Samo cialo nie ma atrybutu, stad ostrzezenie GCC o ABI wektorow, ktore tu nie dotyczy.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+template <typename Ops>
+SIMD_MERGE_INLINE void simdMergeLoop(const typename Ops::T* a, const typename Ops::T* aEnd,
+                                     const typename Ops::T* b, const typename Ops::T* bEnd, typename Ops::T* out) {
+    constexpr std::size_t L = Ops::lanes;
+    typename Ops::V lo = Ops::load(a);
+    typename Ops::V hi = Ops::load(b);
+    a += L;
+    b += L;
+    Ops::merge2(lo, hi);
+    Ops::store(out, lo);
+    out += L;
+
+    while (static_cast<std::size_t>(aEnd - a) >= L && static_cast<std::size_t>(bEnd - b) >= L) {
+        if (*a < *b) {
+            lo = Ops::load(a);
+            a += L;
+        }
+        else {
+            lo = Ops::load(b);
+            b += L;
+        }
+        Ops::merge2(lo, hi);
+        Ops::store(out, lo);
+        out += L;
+    }
+
+    typename Ops::T tail[L];
+    Ops::store(tail, hi);
+    mergeTails(tail, tail + L, a, aEnd, b, bEnd, out);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+template <typename Ops>
+SIMD_SORT_AVX2 void simdMergeAvx2(const typename Ops::T* a, const typename Ops::T* aEnd,
+                                  const typename Ops::T* b, const typename Ops::T* bEnd, typename Ops::T* out) {
+    simdMergeLoop<Ops>(a, aEnd, b, bEnd, out);
+}
+
+template <typename Ops>
+SIMD_SORT_AVX512 void simdMergeAvx512(const typename Ops::T* a, const typename Ops::T* aEnd,
+                                      const typename Ops::T* b, const typename Ops::T* bEnd, typename Ops::T* out) {
+    simdMergeLoop<Ops>(a, aEnd, b, bEnd, out);
+}
+
+#endif
+
+// Serie krotsze niz ten prog scalane sa zawsze skalarnie.
+constexpr std::size_t simdMergeMinRun = 16;
+
+// Wektorowe scalanie a[0..na) i b[0..nb) do out (bez nakladania sie) dla kluczy int32/int64
+// porownywanych std::less. Zwraca false, gdy sciezka SIMD nie ma zastosowania i trzeba uzyc
+// petli skalarnej (inne typy lub komparatory, krotkie serie, brak AVX2).
+template <typename E, typename Compare>
+bool simdMerge(const E* a, std::size_t na, const E* b, std::size_t nb, E* out) {
+#if SIMD_SORT_X86
+    if constexpr (isSimdStableSortable<E, Compare>) {
+        if (na < simdMergeMinRun || nb < simdMergeMinRun) return false;
+
+        if constexpr (sizeof(E) == 4) {
+            if (cpuHasAvx512f()) {
+                simdMergeAvx512<MergeAvx512Int32>(a, a + na, b, b + nb, out);
+                return true;
+            }
+            if (cpuHasAvx2()) {
+                simdMergeAvx2<MergeAvx2Int32>(a, a + na, b, b + nb, out);
+                return true;
+            }
+        }
+        else {
+            if (cpuHasAvx512f()) {
+                simdMergeAvx512<MergeAvx512Int64>(a, a + na, b, b + nb, out);
+                return true;
+            }
+            if (cpuHasAvx2()) {
+                simdMergeAvx2<MergeAvx2Int64>(a, a + na, b, b + nb, out);
+                return true;
+            }
+        }
+    }
+#endif
+    (void)a; (void)na; (void)b; (void)nb; (void)out;
+    return false;
+}
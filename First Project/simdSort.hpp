@@ -0,0 +1,270 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include "InsertionSort.hpp"
+#include "staticSort.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMD_SORT_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SIMD_SORT_AVX2
+#define SIMD_SORT_AVX512
+#else
+#define SIMD_SORT_AVX2 __attribute__((target("avx2")))
+#define SIMD_SORT_AVX512 __attribute__((target("avx512f")))
+#endif
+#else
+#define SIMD_SORT_X86 0
+#endif
+
+// Najwiekszy zakres sortowany siecia bitoniczna w rejestrach.
+constexpr std::size_t simdSortMaxSize = 64;
+
+template <typename E>
+constexpr bool isSimdSortableType =
+    std::is_same<E, std::int32_t>::value || std::is_same<E, std::int64_t>::value ||
+    std::is_same<E, float>::value || std::is_same<E, double>::value;
+
+template <typename E, typename Compare>
+constexpr bool isSimdSortable = isSimdSortableType<E> &&
+    (std::is_same<Compare, std::less<E>>::value || std::is_same<Compare, std::less<>>::value);
+
+// Siec nie jest stabilna; dla liczb calkowitych rowne klucze sa nieodroznialne, ale dla
+// float/double -0.0 i +0.0 sa rowne wedlug std::less, wiec tam stabilne sortowania jej nie uzywaja.
+template <typename E, typename Compare>
+constexpr bool isSimdStableSortable = isSimdSortable<E, Compare> && std::is_integral<E>::value;
+
+// Wykrywanie AVX2 w czasie wykonania, raz na proces.
+inline bool cpuHasAvx2() {
+#if SIMD_SORT_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    static const bool hasAvx2 = [] {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool osxsave = (info[2] >> 27) & 1;
+        bool avx = (info[2] >> 28) & 1;
+        if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+        __cpuidex(info, 7, 0);
+        return ((info[1] >> 5) & 1) != 0;
+    }();
+#else
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+#endif
+    return hasAvx2;
+#else
+    return false;
+#endif
+}
+
+// Wykrywanie AVX-512F (razem z obsluga rejestrow zmask/zmm przez system), raz na proces.
+inline bool cpuHasAvx512f() {
+#if SIMD_SORT_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    static const bool hasAvx512f = [] {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        if (!((info[2] >> 27) & 1) || (_xgetbv(0) & 0xE6) != 0xE6) return false;
+        __cpuidex(info, 7, 0);
+        return ((info[1] >> 16) & 1) != 0;
+    }();
+#else
+    static const bool hasAvx512f = __builtin_cpu_supports("avx512f");
+#endif
+    return hasAvx512f;
+#else
+    return false;
+#endif
+}
+
+#if SIMD_SORT_X86
+
+// Operacje na wektorze 256-bitowym dla jednego typu klucza. Wszystkie typy trzymane sa jako
+// __m256i; min/max wybierane sa maska porownania, wiec wartosci (np. -0.0) nie sa zmieniane.
+struct SimdInt32 {
+    using T = std::int32_t;
+    static constexpr int lanes = 8;
+    static T padding() { return std::numeric_limits<T>::max(); }
+    SIMD_SORT_AVX2 static __m256i lessMask(__m256i a, __m256i b) { return _mm256_cmpgt_epi32(b, a); }
+};
+
+struct SimdInt64 {
+    using T = std::int64_t;
+    static constexpr int lanes = 4;
+    static T padding() { return std::numeric_limits<T>::max(); }
+    SIMD_SORT_AVX2 static __m256i lessMask(__m256i a, __m256i b) { return _mm256_cmpgt_epi64(b, a); }
+};
+
+struct SimdFloat {
+    using T = float;
+    static constexpr int lanes = 8;
+    static T padding() { return std::numeric_limits<T>::infinity(); }
+    SIMD_SORT_AVX2 static __m256i lessMask(__m256i a, __m256i b) {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_LT_OQ));
+    }
+};
+
+struct SimdDouble {
+    using T = double;
+    static constexpr int lanes = 4;
+    static T padding() { return std::numeric_limits<T>::infinity(); }
+    SIMD_SORT_AVX2 static __m256i lessMask(__m256i a, __m256i b) {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_LT_OQ));
+    }
+};
+
+template <typename E> struct SimdOpsFor;
+template <> struct SimdOpsFor<std::int32_t> { using type = SimdInt32; };
+template <> struct SimdOpsFor<std::int64_t> { using type = SimdInt64; };
+template <> struct SimdOpsFor<float> { using type = SimdFloat; };
+template <> struct SimdOpsFor<double> { using type = SimdDouble; };
+
+// Krok porownaj-zamien miedzy kazdym elementem wektora a jego partnerem (indeks ^ j) wewnatrz
+// tego samego wektora. Pas bierze maksimum, gdy jest gorna polowka pary w ciagu rosnacym
+// albo dolna w malejacym; kierunek pasa wynika z (indeks & k).
+template <typename Ops>
+SIMD_SORT_AVX2 inline __m256i bitonicStepInRegister(__m256i v, int base, int k, int j) {
+    constexpr int words = 8 / Ops::lanes;
+    alignas(32) std::int32_t permutation[8];
+    alignas(32) std::int32_t takeMax[8];
+    for (int w = 0; w < 8; ++w) {
+        int lane = w / words;
+        permutation[w] = (lane ^ j) * words + w % words;
+        bool ascending = ((base + lane) & k) == 0;
+        bool upper = (lane & j) != 0;
+        takeMax[w] = upper == ascending ? -1 : 0;
+    }
+
+    // Obie polowki pary podejmuja te sama decyzje o zamianie, wiec rowne (ale rozne bitowo)
+    // wartosci nie sa duplikowane.
+    __m256i partner = _mm256_permutevar8x32_epi32(v, _mm256_load_si256(reinterpret_cast<const __m256i*>(permutation)));
+    __m256i takePartner = _mm256_blendv_epi8(Ops::lessMask(partner, v), Ops::lessMask(v, partner),
+                                             _mm256_load_si256(reinterpret_cast<const __m256i*>(takeMax)));
+    return _mm256_blendv_epi8(v, partner, takePartner);
+}
+
+// Pelna siec bitoniczna dla P elementow (P potega dwojki, wielokrotnosc liczby pasow)
+// trzymanych w P / lanes rejestrach.
+template <typename Ops, int P>
+SIMD_SORT_AVX2 void bitonicSortRegisters(typename Ops::T* data) {
+    constexpr int L = Ops::lanes;
+    constexpr int R = P / L;
+    __m256i v[R];
+    for (int r = 0; r < R; ++r) {
+        v[r] = _mm256_load_si256(reinterpret_cast<const __m256i*>(data + r * L));
+    }
+
+    for (int k = 2; k <= P; k <<= 1) {
+        for (int j = k >> 1; j > 0; j >>= 1) {
+            if (R > 1 && j >= L) {
+                const int rj = j / L;
+                for (int a = 0; a < R; ++a) {
+                    if (a & rj) continue;
+                    const int b = a | rj;
+                    const bool ascending = ((a * L) & k) == 0;
+                    __m256i lt = Ops::lessMask(v[a], v[b]);
+                    __m256i lo = _mm256_blendv_epi8(v[b], v[a], lt);
+                    __m256i hi = _mm256_blendv_epi8(v[a], v[b], lt);
+                    v[a] = ascending ? lo : hi;
+                    v[b] = ascending ? hi : lo;
+                }
+            }
+            else {
+                for (int r = 0; r < R; ++r) {
+                    v[r] = bitonicStepInRegister<Ops>(v[r], r * L, k, j);
+                }
+            }
+        }
+    }
+
+    for (int r = 0; r < R; ++r) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(data + r * L), v[r]);
+    }
+}
+
+// Kopiuje arr[0..n) do wyrownanego bufora dopelnionego maksymalna wartoscia, sortuje
+// najmniejsza pasujaca siecia i przepisuje n najmniejszych elementow z powrotem.
+template <typename E>
+SIMD_SORT_AVX2 void simdSortSmall(E* arr, std::size_t n) {
+    using Ops = typename SimdOpsFor<E>::type;
+    alignas(32) E buffer[simdSortMaxSize];
+
+    std::size_t padded = Ops::lanes;
+    while (padded < n) padded <<= 1;
+    for (std::size_t i = 0; i < n; ++i) buffer[i] = arr[i];
+    for (std::size_t i = n; i < padded; ++i) buffer[i] = Ops::padding();
+
+    switch (padded / Ops::lanes) {
+    case 1: bitonicSortRegisters<Ops, Ops::lanes>(buffer); break;
+    case 2: bitonicSortRegisters<Ops, 2 * Ops::lanes>(buffer); break;
+    case 4: bitonicSortRegisters<Ops, 4 * Ops::lanes>(buffer); break;
+    case 8: bitonicSortRegisters<Ops, 8 * Ops::lanes>(buffer); break;
+    default: bitonicSortRegisters<Ops, static_cast<int>(simdSortMaxSize)>(buffer); break;
+    }
+
+    for (std::size_t i = 0; i < n; ++i) arr[i] = buffer[i];
+}
+
+#endif
+
+template <typename E, typename Compare>
+bool useSimdSmallSort(std::size_t n) {
+#if SIMD_SORT_X86
+    if constexpr (isSimdSortable<E, Compare>) {
+        return n <= simdSortMaxSize && cpuHasAvx2();
+    }
+#endif
+    (void)n;
+    return false;
+}
+
+template <typename E, typename Compare>
+bool useSimdStableSmallSort(std::size_t n) {
+    if constexpr (isSimdStableSortable<E, Compare>) {
+        return useSimdSmallSort<E, Compare>(n);
+    }
+    (void)n;
+    return false;
+}
+
+// Sortuje arr[left..right]: liczby i wskazniki do staticSortMaxSize elementow skalarna siecia
+// ze staticSort, wieksze zakresy siecia bitoniczna AVX2 dla kluczy prostych porownywanych
+// std::less, gdy procesor ja obsluguje, a w pozostalych przypadkach insertionSort.
+template <typename E, typename Compare>
+void smallSort(E* arr, std::size_t left, std::size_t right, const Compare& less) {
+    if (left >= right) return;
+    if constexpr (isStaticSortable<E>) {
+        if (right - left + 1 <= staticSortMaxSize) {
+            staticSort(arr + left, right - left + 1, less);
+            return;
+        }
+    }
+#if SIMD_SORT_X86
+    if constexpr (isSimdSortable<E, Compare>) {
+        if (useSimdSmallSort<E, Compare>(right - left + 1)) {
+            simdSortSmall(arr + left, right - left + 1);
+            return;
+        }
+    }
+#endif
+    insertionSort(arr, left, right, less);
+}
+
+// Wariant dla sortowan stabilnych - siec tylko tam, gdzie kolejnosc rownych kluczy jest niewidoczna.
+template <typename E, typename Compare>
+void stableSmallSort(E* arr, std::size_t left, std::size_t right, const Compare& less) {
+    if (left >= right) return;
+    if (useSimdStableSmallSort<E, Compare>(right - left + 1)) {
+        smallSort(arr, left, right, less);
+        return;
+    }
+    insertionSort(arr, left, right, less);
+}
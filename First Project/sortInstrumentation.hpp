@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// Liczniki zbierane przez CountingInstrumentation. Zamiana to jeden swap, a nie trzy przeniesienia.
+struct SortCounters {
+    std::uint64_t comparisons = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t swaps = 0;
+    std::size_t maxDepth = 0;
+    std::uint64_t partitions = 0;
+    // Suma rozmiarow partycjonowanych zakresow i ich najwiekszych czesci po podziale;
+    // iloraz to niezrownowazenie podzialow (okolo 0.5 dla dobrych pivotow, blisko 1 dla zlych).
+    std::uint64_t partitionedElements = 0;
+    std::uint64_t largestPartElements = 0;
+    std::uint64_t insertionFallbacks = 0;
+    std::uint64_t heapFallbacks = 0;
+    std::uint64_t bytesAllocated = 0;
+
+    double imbalance() const {
+        return partitionedElements == 0 ? 0.0 : static_cast<double>(largestPartElements) / static_cast<double>(partitionedElements);
+    }
+};
+
+// Polityki instrumentacji sortowan: statyczne funkcje wywolywane w jadrach. Domyslna nie robi
+// nic, wiec kompilator usuwa wywolania i kod jest taki sam jak bez instrumentacji.
+struct NoInstrumentation {
+    static constexpr bool enabled = false;
+
+    static void compare() {}
+    static void move(std::size_t = 1) {}
+    static void swap() {}
+    static void depth(std::size_t) {}
+    static void partition(std::size_t, std::size_t) {}
+    static void insertionFallback() {}
+    static void heapFallback() {}
+    static void allocate(std::size_t) {}
+};
+
+// Liczniki osobne dla kazdego watku; reset() przed sortowaniem, counters() po nim.
+struct CountingInstrumentation {
+    static constexpr bool enabled = true;
+
+    static SortCounters& counters() {
+        thread_local SortCounters values;
+        return values;
+    }
+
+    static void reset() { counters() = SortCounters{}; }
+
+    static void compare() { ++counters().comparisons; }
+    static void move(std::size_t count = 1) { counters().moves += count; }
+    static void swap() { ++counters().swaps; }
+    static void depth(std::size_t depth) {
+        if (depth > counters().maxDepth) counters().maxDepth = depth;
+    }
+    static void partition(std::size_t size, std::size_t largestPart) {
+        SortCounters& values = counters();
+        ++values.partitions;
+        values.partitionedElements += size;
+        values.largestPartElements += largestPart;
+    }
+    static void insertionFallback() { ++counters().insertionFallbacks; }
+    static void heapFallback() { ++counters().heapFallbacks; }
+    static void allocate(std::size_t bytes) { counters().bytesAllocated += bytes; }
+};
+
+// Komparator liczacy porownania. Sortowania z wlaczona instrumentacja opakowuja nim less raz,
+// na wejsciu; przy okazji wylacza to sciezki SIMD i radix (wymagaja std::less), wiec liczniki
+// opisuja skalarny przebieg algorytmu.
+template <typename Compare, typename Instrumentation>
+struct CountingCompare {
+    const Compare& less;
+
+    template <typename A, typename B>
+    bool operator()(const A& a, const B& b) const {
+        Instrumentation::compare();
+        return less(a, b);
+    }
+};
+
+template <typename Compare>
+struct isCountingCompare : std::false_type {};
+
+template <typename Compare, typename Instrumentation>
+struct isCountingCompare<CountingCompare<Compare, Instrumentation>> : std::true_type {};
+
+template <typename Instrumentation, typename Compare>
+constexpr bool needsCountingCompare = Instrumentation::enabled && !isCountingCompare<Compare>::value;
+
+template <typename Instrumentation, typename E>
+void countedSwap(E& a, E& b) {
+    Instrumentation::swap();
+    std::swap(a, b);
+}
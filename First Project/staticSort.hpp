@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <array>
+#include <type_traits>
+#include <utility>
+
+// Najwiekszy rozmiar, dla ktorego generowane sa sieci sortujace.
+constexpr std::size_t staticSortMaxSize = 32;
+
+// Sieci do tego rozmiaru sa rozwijane w kod bez petli; wieksze (po 85-191 komparatorow)
+// wykonuje petla po tablicy komparatorow, bo rozwiniete kilkukrotnie wydluzaja kompilacje.
+constexpr std::size_t staticSortUnrollMaxSize = 16;
+
+// Typy, dla ktorych siec (stala liczba porownan, bez skokow) oplaca sie bardziej niz
+// insertionSort: liczby i wskazniki, dla ktorych wymiana kompiluje sie do min/max albo cmov.
+// Dla struktur kompilator zostawia skoki i siec przegrywa z insertionSort.
+template <typename E>
+constexpr bool isStaticSortable = std::is_arithmetic<E>::value || std::is_pointer<E>::value;
+
+// Bezskokowa wymiana: po wywolaniu a nie jest wieksze od b.
+template <typename E, typename Compare>
+constexpr void compareExchange(E& a, E& b, const Compare& less) {
+    bool swapped = less(b, a);
+    E low = swapped ? b : a;
+    E high = swapped ? a : b;
+    a = low;
+    b = high;
+}
+
+// Siec scalania parzysto-nieparzystego Batchera dla dowolnego n (komparatory wychodzace poza n
+// sa pomijane). Dla n <= 8 daje sieci optymalne, do 16 najwyzej kilka komparatorow wiecej
+// niz najlepsze znane (63 zamiast 60 dla 16), powyzej roznica rosnie (191 zamiast 185 dla 32).
+template <typename Visit>
+constexpr void forEachComparator(std::size_t n, Visit visit) {
+    for (std::size_t p = 1; p < n; p += p) {
+        for (std::size_t k = p; k > 0; k /= 2) {
+            for (std::size_t j = k % p; j + k < n; j += k + k) {
+                for (std::size_t i = 0; i < k && i + j + k < n; ++i) {
+                    if ((i + j) / (p + p) == (i + j + k) / (p + p)) visit(i + j, i + j + k);
+                }
+            }
+        }
+    }
+}
+
+constexpr std::size_t sortingNetworkSize(std::size_t n) {
+    std::size_t count = 0;
+    forEachComparator(n, [&count](std::size_t, std::size_t) { ++count; });
+    return count;
+}
+
+// Komparatory sieci dla N elementow wyliczane w czasie kompilacji.
+template <std::size_t N>
+struct SortingNetwork {
+    static constexpr std::size_t size = sortingNetworkSize(N);
+
+    static constexpr std::array<std::pair<std::size_t, std::size_t>, size> build() {
+        std::array<std::pair<std::size_t, std::size_t>, size> comparators{};
+        std::size_t count = 0;
+        forEachComparator(N, [&](std::size_t a, std::size_t b) {
+            comparators[count].first = a;
+            comparators[count].second = b;
+            ++count;
+        });
+        return comparators;
+    }
+
+    static constexpr std::array<std::pair<std::size_t, std::size_t>, size> comparators = build();
+};
+
+// Rozwiniecie sieci w ciag wymian o stalych indeksach, bez petli.
+template <std::size_t N, typename E, typename Compare, std::size_t... I>
+constexpr void applySortingNetwork([[maybe_unused]] E* arr, [[maybe_unused]] const Compare& less, std::index_sequence<I...>) {
+    (compareExchange(arr[SortingNetwork<N>::comparators[I].first], arr[SortingNetwork<N>::comparators[I].second], less), ...);
+}
+
+// Sortuje arr[0..N) siecia wygenerowana dla N; dziala tez w wyrazeniach constexpr.
+template <std::size_t N, typename E, typename Compare = std::less<E>>
+constexpr void staticSort(E* arr, const Compare& less = Compare{}) {
+    static_assert(N <= staticSortMaxSize, "staticSort obsluguje najwyzej staticSortMaxSize elementow");
+    if constexpr (N <= staticSortUnrollMaxSize) {
+        applySortingNetwork<N>(arr, less, std::make_index_sequence<SortingNetwork<N>::size>{});
+    }
+    else {
+        for (const auto& comparator : SortingNetwork<N>::comparators) {
+            compareExchange(arr[comparator.first], arr[comparator.second], less);
+        }
+    }
+}
+
+template <typename E, typename Compare, std::size_t... N>
+constexpr void staticSortDispatch(E* arr, std::size_t size, const Compare& less, std::index_sequence<N...>) {
+    using Network = void (*)(E*, const Compare&);
+    constexpr Network networks[] = { &staticSort<N, E, Compare>... };
+    networks[size](arr, less);
+}
+
+// Wybor sieci dla rozmiaru znanego dopiero w czasie wykonania (size <= staticSortMaxSize):
+// skok przez tablice funkcji, wiec kazda siec jest kompilowana raz, a nie w kazdym miejscu wywolania.
+template <typename E, typename Compare = std::less<E>>
+constexpr void staticSort(E* arr, std::size_t size, const Compare& less = Compare{}) {
+    staticSortDispatch(arr, size, less, std::make_index_sequence<staticSortMaxSize + 1>{});
+}
@@ -0,0 +1,204 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "InsertionSort.hpp"
+#include "IntroSort.hpp"
+#include "indirectSort.hpp"
+
+// Zakresy tej wielkosci multikeyQuickSort konczy sortowaniem przez wstawianie.
+constexpr std::size_t multikeyQuickSortCutoff = 16;
+
+// Kubelek burstSort wiekszy niz ten prog (elementy po 32 bajty) jest rozbijany na nowy wezel trie.
+constexpr std::size_t burstSortBucketSize = 4096;
+
+// Klucz tekstowy z 8 bajtami zaczynajacymi sie na biezacej glebokosci, zapisanymi jak w keyPrefix.
+// Dopoki slowa sie roznia, porownanie nie siega do pamieci napisu.
+struct StringKey {
+    std::uint64_t word;
+    const char* data;
+    std::size_t length;
+    std::size_t index;
+};
+
+inline void loadStringWord(StringKey& key, std::size_t depth) {
+    key.word = depth < key.length ? keyPrefix(key.data + depth, key.length - depth) : 0;
+}
+
+// Porownanie kluczy o wspolnych bajtach [0, depth) i slowach wczytanych od depth.
+// Przy rownych slowach krotszy napis konczacy sie w obrebie slowa jest prefiksem dluzszego.
+inline bool stringKeyLess(const StringKey& a, const StringKey& b, std::size_t depth) {
+    if (a.word != b.word) return a.word < b.word;
+    std::size_t skip = depth + 8;
+    if (a.length <= skip || b.length <= skip) return a.length < b.length;
+    return std::string_view(a.data + skip, a.length - skip) < std::string_view(b.data + skip, b.length - skip);
+}
+
+// Wieloklawiszowy quicksort Bentleya-Sedgewicka, w ktorym "znakiem" jest 8-bajtowe slowo:
+// podzial trojdrogowy po slowie, a grupa rownych slow przechodzi o 8 bajtow dalej.
+inline void multikeyQuickSort_recursive(StringKey* keys, std::size_t size, std::size_t depth) {
+    while (size > multikeyQuickSortCutoff) {
+        std::uint64_t a = keys[0].word;
+        std::uint64_t b = keys[size / 2].word;
+        std::uint64_t c = keys[size - 1].word;
+        std::uint64_t pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+        std::size_t lt = 0, i = 0, gt = size;
+        while (i < gt) {
+            if (keys[i].word < pivot) std::swap(keys[lt++], keys[i++]);
+            else if (keys[i].word > pivot) std::swap(keys[i], keys[--gt]);
+            else ++i;
+        }
+
+        multikeyQuickSort_recursive(keys, lt, depth);
+        multikeyQuickSort_recursive(keys + gt, size - gt, depth);
+
+        // Napisy konczace sie w obrebie slowa ida przed dluzsze i roznia sie tylko dlugoscia.
+        StringKey* equal = keys + lt;
+        std::size_t equalSize = gt - lt;
+        std::size_t ended = 0;
+        for (std::size_t j = 0; j < equalSize; ++j) {
+            if (equal[j].length <= depth + 8) std::swap(equal[ended++], equal[j]);
+        }
+        if (ended > 1) {
+            introSort(equal, ended, [](const StringKey& x, const StringKey& y) { return x.length < y.length; });
+        }
+
+        keys = equal + ended;
+        size = equalSize - ended;
+        depth += 8;
+        for (std::size_t j = 0; j < size; ++j) loadStringWord(keys[j], depth);
+    }
+    if (size > 1) {
+        insertionSort(keys, 0, size - 1, [depth](const StringKey& x, const StringKey& y) { return stringKeyLess(x, y, depth); });
+    }
+}
+
+// Wezel trie burstSort na glebokosci depth: napisy konczace sie tutaj, a dla kazdego kolejnego
+// bajtu albo kubelek nieposortowanych kluczy, albo poddrzewo. Slowa kluczy sa wczytane od
+// glebokosci depth zaokraglonej w dol do wielokrotnosci 8.
+struct BurstTrieNode {
+    std::vector<StringKey> ended;
+    std::vector<StringKey> buckets[256];
+    std::unique_ptr<BurstTrieNode> children[256];
+};
+
+inline void burstTrieInsert(BurstTrieNode* node, std::size_t depth, StringKey key);
+
+// Zamienia przepelniony kubelek na wezel o glebokosci depth + 1.
+inline void burstTrieBurst(BurstTrieNode* node, std::size_t depth, unsigned byte) {
+    std::vector<StringKey> bucket;
+    bucket.swap(node->buckets[byte]);
+    node->children[byte] = std::make_unique<BurstTrieNode>();
+
+    BurstTrieNode* child = node->children[byte].get();
+    for (StringKey& key : bucket) {
+        if ((depth + 1) % 8 == 0) loadStringWord(key, depth + 1);
+        burstTrieInsert(child, depth + 1, key);
+    }
+}
+
+inline void burstTrieInsert(BurstTrieNode* node, std::size_t depth, StringKey key) {
+    while (true) {
+        if (depth >= key.length) {
+            node->ended.push_back(key);
+            return;
+        }
+
+        unsigned byte = static_cast<unsigned>(key.word >> (56 - 8 * (depth % 8))) & 0xFF;
+        if (node->children[byte]) {
+            node = node->children[byte].get();
+            ++depth;
+            if (depth % 8 == 0) loadStringWord(key, depth);
+            continue;
+        }
+
+        std::vector<StringKey>& bucket = node->buckets[byte];
+        bucket.push_back(key);
+        if (bucket.size() > burstSortBucketSize) burstTrieBurst(node, depth, byte);
+        return;
+    }
+}
+
+// Przejscie trie w porzadku bajtow; kubelki sa sortowane multikeyQuickSort od slowa, ktore juz
+// maja wczytane (wspolne bajty na jego poczatku nie zmieniaja wyniku).
+inline void burstTrieCollect(BurstTrieNode* node, std::size_t depth, std::vector<std::size_t>& order) {
+    for (const StringKey& key : node->ended) order.push_back(key.index);
+
+    for (unsigned byte = 0; byte < 256; ++byte) {
+        if (node->children[byte]) {
+            burstTrieCollect(node->children[byte].get(), depth + 1, order);
+            continue;
+        }
+        std::vector<StringKey>& bucket = node->buckets[byte];
+        multikeyQuickSort_recursive(bucket.data(), bucket.size(), depth / 8 * 8);
+        for (const StringKey& key : bucket) order.push_back(key.index);
+    }
+}
+
+// Klucze wszystkich napisow; wspolny prefiks calej tablicy jest od razu pomijany, bo
+// w kluczach typu URL zajmuje kilka slow, ktore inaczej trzeba by wczytywac dla kazdego napisu.
+// S to std::string albo std::string_view.
+template <typename S>
+std::vector<StringKey> makeStringKeys(const S* arr, std::size_t size) {
+    std::size_t common = size > 0 ? arr[0].size() : 0;
+    for (std::size_t i = 1; i < size && common > 0; ++i) {
+        std::size_t limit = std::min(common, arr[i].size());
+        std::size_t j = 0;
+        while (j < limit && arr[i][j] == arr[0][j]) ++j;
+        common = j;
+    }
+
+    std::vector<StringKey> keys(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        keys[i].data = arr[i].data() + common;
+        keys[i].length = arr[i].size() - common;
+        keys[i].index = i;
+        loadStringWord(keys[i], 0);
+    }
+    return keys;
+}
+
+// Przenosi napisy w kolejnosci posortowanych indeksow. Kopia przez bufor zamiast cykli
+// applyPermutation: kolejne odczyty sa od siebie niezalezne, wiec chybienia w pamieci sie nakladaja.
+template <typename S, typename Indices>
+void moveStringsInOrder(S* arr, std::size_t size, const Indices& indices) {
+    std::vector<S> sorted;
+    sorted.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) sorted.push_back(std::move(arr[indices(i)]));
+    std::move(sorted.begin(), sorted.end(), arr);
+}
+
+// Sortuje napisy rosnaco (porzadek bajtow jak std::less<std::string>). Sortowane sa klucze
+// z buforowanym prefiksem, napisy przenoszone sa raz na koniec.
+template <typename S>
+void multikeyQuickSort(S* arr, std::size_t size) {
+    if (size < 2) return;
+
+    std::vector<StringKey> keys = makeStringKeys(arr, size);
+    multikeyQuickSort_recursive(keys.data(), size, 0);
+    moveStringsInOrder(arr, size, [&](std::size_t i) { return keys[i].index; });
+}
+
+// Burstsort: MSD radix po pojedynczych bajtach, w ktorym kubelki rosna jako male tablice,
+// a dopiero po przekroczeniu burstSortBucketSize sa rozbijane na kolejny poziom trie.
+// Kubelki na koncu konczy multikeyQuickSort, gdy mieszcza sie juz w pamieci podrecznej.
+template <typename S>
+void burstSort(S* arr, std::size_t size) {
+    if (size < 2) return;
+
+    std::vector<StringKey> keys = makeStringKeys(arr, size);
+    BurstTrieNode root;
+    for (const StringKey& key : keys) burstTrieInsert(&root, 0, key);
+    keys.clear();
+    keys.shrink_to_fit();
+
+    std::vector<std::size_t> order;
+    order.reserve(size);
+    burstTrieCollect(&root, 0, order);
+    moveStringsInOrder(arr, size, [&](std::size_t i) { return order[i]; });
+}
@@ -0,0 +1,447 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include "SortWorkspace.hpp"
+
+// Tablice krotsze niz ten prog sortowane sa samym binarnym wstawianiem.
+constexpr std::ptrdiff_t timSortMinMerge = 32;
+
+// Ile wygranych z rzedu jednej serii przelacza scalanie w tryb galopowania.
+constexpr std::ptrdiff_t timSortMinGallop = 7;
+
+// Pozycja, na ktora trafilby key w posortowanym base[0..len): pierwszy element >= key.
+// Wyszukiwanie wykladnicze zaczyna sie od base[hint].
+template <typename E, typename Compare>
+std::ptrdiff_t gallopLeft(const E& key, const E* base, std::ptrdiff_t len, std::ptrdiff_t hint, const Compare& less) {
+    std::ptrdiff_t lastOfs = 0;
+    std::ptrdiff_t ofs = 1;
+
+    if (less(base[hint], key)) {
+        std::ptrdiff_t maxOfs = len - hint;
+        while (ofs < maxOfs && less(base[hint + ofs], key)) {
+            lastOfs = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        if (ofs > maxOfs) ofs = maxOfs;
+        lastOfs += hint;
+        ofs += hint;
+    }
+    else {
+        std::ptrdiff_t maxOfs = hint + 1;
+        while (ofs < maxOfs && !less(base[hint - ofs], key)) {
+            lastOfs = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        if (ofs > maxOfs) ofs = maxOfs;
+        std::ptrdiff_t tmp = lastOfs;
+        lastOfs = hint - ofs;
+        ofs = hint - tmp;
+    }
+
+    ++lastOfs;
+    while (lastOfs < ofs) {
+        std::ptrdiff_t m = lastOfs + (ofs - lastOfs) / 2;
+        if (less(base[m], key)) lastOfs = m + 1;
+        else ofs = m;
+    }
+    return ofs;
+}
+
+// Jak gallopLeft, ale zwraca pierwszy element > key (rowne klucze zostaja przed key).
+template <typename E, typename Compare>
+std::ptrdiff_t gallopRight(const E& key, const E* base, std::ptrdiff_t len, std::ptrdiff_t hint, const Compare& less) {
+    std::ptrdiff_t lastOfs = 0;
+    std::ptrdiff_t ofs = 1;
+
+    if (less(key, base[hint])) {
+        std::ptrdiff_t maxOfs = hint + 1;
+        while (ofs < maxOfs && less(key, base[hint - ofs])) {
+            lastOfs = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        if (ofs > maxOfs) ofs = maxOfs;
+        std::ptrdiff_t tmp = lastOfs;
+        lastOfs = hint - ofs;
+        ofs = hint - tmp;
+    }
+    else {
+        std::ptrdiff_t maxOfs = len - hint;
+        while (ofs < maxOfs && !less(key, base[hint + ofs])) {
+            lastOfs = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        if (ofs > maxOfs) ofs = maxOfs;
+        lastOfs += hint;
+        ofs += hint;
+    }
+
+    ++lastOfs;
+    while (lastOfs < ofs) {
+        std::ptrdiff_t m = lastOfs + (ofs - lastOfs) / 2;
+        if (less(key, base[m])) ofs = m;
+        else lastOfs = m + 1;
+    }
+    return ofs;
+}
+
+// Stabilne wstawianie binarne arr[start..hi) do posortowanego juz arr[lo..start).
+template <typename E, typename Compare>
+void binaryInsertionSort(E* arr, std::ptrdiff_t lo, std::ptrdiff_t hi, std::ptrdiff_t start, const Compare& less) {
+    if (start == lo) ++start;
+    for (; start < hi; ++start) {
+        E pivot = arr[start];
+        E* pos = std::upper_bound(arr + lo, arr + start, pivot, less);
+        std::move_backward(pos, arr + start, arr + start + 1);
+        *pos = pivot;
+    }
+}
+
+// Dlugosc serii zaczynajacej sie w lo; seria scisle malejaca jest odwracana w miejscu
+// (scisla nierownosc gwarantuje, ze odwrocenie nie psuje stabilnosci).
+template <typename E, typename Compare>
+std::ptrdiff_t countRunAndMakeAscending(E* arr, std::ptrdiff_t lo, std::ptrdiff_t hi, const Compare& less) {
+    std::ptrdiff_t runHi = lo + 1;
+    if (runHi == hi) return 1;
+
+    if (less(arr[runHi++], arr[lo])) {
+        while (runHi < hi && less(arr[runHi], arr[runHi - 1])) ++runHi;
+        std::reverse(arr + lo, arr + runHi);
+    }
+    else {
+        while (runHi < hi && !less(arr[runHi], arr[runHi - 1])) ++runHi;
+    }
+    return runHi - lo;
+}
+
+// Minimalna dlugosc serii: n/2^k w przedziale [timSortMinMerge/2, timSortMinMerge].
+inline std::ptrdiff_t timSortMinRun(std::ptrdiff_t n) {
+    std::ptrdiff_t r = 0;
+    while (n >= timSortMinMerge) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+// Powersort: "moc" granicy miedzy seriami [s1, s1+n1) i [s1+n1, s1+n1+n2) to numer pierwszego
+// bitu, na ktorym roznia sie polozenia srodkow obu serii (jako ulamki dlugosci n).
+inline int powerSortNodePower(std::size_t n, std::size_t s1, std::size_t n1, std::size_t n2) {
+    std::size_t a = 2 * s1 + n1;
+    std::size_t b = a + n1 + n2;
+    int power = 0;
+    while (true) {
+        ++power;
+        if (a >= n) {
+            a -= n;
+            b -= n;
+        }
+        else if (b >= n) {
+            break;
+        }
+        a <<= 1;
+        b <<= 1;
+    }
+    return power;
+}
+
+template <typename E, typename Compare>
+class TimSortState {
+    struct Run {
+        std::ptrdiff_t base;
+        std::ptrdiff_t len;
+        int power;
+    };
+
+    E* arr;
+    E* tmp;
+    const Compare& less;
+    std::ptrdiff_t minGallop = timSortMinGallop;
+    // Stos serii o stalej pojemnosci: moce wezlow na stosie rosna scisle i nie przekraczaja
+    // log2(n) + 1, wiec stos nie alokuje pamieci.
+    Run runs[std::numeric_limits<std::size_t>::digits + 2];
+    std::size_t runCount = 0;
+
+public:
+    TimSortState(E* arr, E* tmp, const Compare& less) : arr(arr), tmp(tmp), less(less) {}
+
+    void pushRun(std::ptrdiff_t n, std::ptrdiff_t base, std::ptrdiff_t len) {
+        if (runCount == 0) {
+            runs[runCount++] = { base, len, 0 };
+            return;
+        }
+        const Run& top = runs[runCount - 1];
+        int power = powerSortNodePower(static_cast<std::size_t>(n), static_cast<std::size_t>(top.base),
+                                       static_cast<std::size_t>(top.len), static_cast<std::size_t>(len));
+        while (runCount >= 2 && runs[runCount - 1].power > power) {
+            mergeAt(runCount - 2);
+        }
+        runs[runCount++] = { base, len, power };
+    }
+
+    void mergeAll() {
+        while (runCount >= 2) {
+            mergeAt(runCount - 2);
+        }
+    }
+
+private:
+    // Scala serie i oraz i+1; elementy juz stojace na swoim miejscu sa pomijane galopowaniem.
+    void mergeAt(std::size_t i) {
+        std::ptrdiff_t base1 = runs[i].base;
+        std::ptrdiff_t len1 = runs[i].len;
+        std::ptrdiff_t base2 = runs[i + 1].base;
+        std::ptrdiff_t len2 = runs[i + 1].len;
+
+        runs[i].len = len1 + len2;
+        --runCount; // scalane sa zawsze dwie gorne serie
+
+        std::ptrdiff_t k = gallopRight(arr[base2], arr + base1, len1, 0, less);
+        base1 += k;
+        len1 -= k;
+        if (len1 == 0) return;
+
+        len2 = gallopLeft(arr[base1 + len1 - 1], arr + base2, len2, len2 - 1, less);
+        if (len2 == 0) return;
+
+        if (len1 <= len2) mergeLo(base1, len1, base2, len2);
+        else mergeHi(base1, len1, base2, len2);
+    }
+
+    // Krotsza pierwsza seria trafia do tmp, scalanie od lewej.
+    void mergeLo(std::ptrdiff_t base1, std::ptrdiff_t len1, std::ptrdiff_t base2, std::ptrdiff_t len2) {
+        std::copy(arr + base1, arr + base1 + len1, tmp);
+        std::ptrdiff_t cursor1 = 0;
+        std::ptrdiff_t cursor2 = base2;
+        std::ptrdiff_t dest = base1;
+
+        arr[dest++] = arr[cursor2++];
+        if (--len2 == 0) {
+            std::copy(tmp + cursor1, tmp + cursor1 + len1, arr + dest);
+            return;
+        }
+        if (len1 == 1) {
+            std::copy(arr + cursor2, arr + cursor2 + len2, arr + dest);
+            arr[dest + len2] = tmp[cursor1];
+            return;
+        }
+
+        std::ptrdiff_t gallop = minGallop;
+        while (true) {
+            std::ptrdiff_t count1 = 0;
+            std::ptrdiff_t count2 = 0;
+            bool done = false;
+
+            do {
+                if (less(arr[cursor2], tmp[cursor1])) {
+                    arr[dest++] = arr[cursor2++];
+                    ++count2;
+                    count1 = 0;
+                    if (--len2 == 0) { done = true; break; }
+                }
+                else {
+                    arr[dest++] = tmp[cursor1++];
+                    ++count1;
+                    count2 = 0;
+                    if (--len1 == 1) { done = true; break; }
+                }
+            } while ((count1 | count2) < gallop);
+            if (done) break;
+
+            do {
+                count1 = gallopRight(arr[cursor2], tmp + cursor1, len1, 0, less);
+                if (count1 != 0) {
+                    std::copy(tmp + cursor1, tmp + cursor1 + count1, arr + dest);
+                    dest += count1;
+                    cursor1 += count1;
+                    len1 -= count1;
+                    if (len1 <= 1) { done = true; break; }
+                }
+                arr[dest++] = arr[cursor2++];
+                if (--len2 == 0) { done = true; break; }
+
+                count2 = gallopLeft(tmp[cursor1], arr + cursor2, len2, 0, less);
+                if (count2 != 0) {
+                    std::copy(arr + cursor2, arr + cursor2 + count2, arr + dest);
+                    dest += count2;
+                    cursor2 += count2;
+                    len2 -= count2;
+                    if (len2 == 0) { done = true; break; }
+                }
+                arr[dest++] = tmp[cursor1++];
+                if (--len1 == 1) { done = true; break; }
+                --gallop;
+            } while (count1 >= timSortMinGallop || count2 >= timSortMinGallop);
+            if (done) break;
+
+            if (gallop < 0) gallop = 0;
+            gallop += 2;
+        }
+        minGallop = gallop < 1 ? 1 : gallop;
+
+        if (len1 == 1) {
+            std::copy(arr + cursor2, arr + cursor2 + len2, arr + dest);
+            arr[dest + len2] = tmp[cursor1];
+        }
+        else if (len1 == 0) {
+            throw std::invalid_argument("Komparator nie jest scislym porzadkiem slabym");
+        }
+        else {
+            std::copy(tmp + cursor1, tmp + cursor1 + len1, arr + dest);
+        }
+    }
+
+    // Krotsza druga seria trafia do tmp, scalanie od prawej.
+    void mergeHi(std::ptrdiff_t base1, std::ptrdiff_t len1, std::ptrdiff_t base2, std::ptrdiff_t len2) {
+        std::copy(arr + base2, arr + base2 + len2, tmp);
+        std::ptrdiff_t cursor1 = base1 + len1 - 1;
+        std::ptrdiff_t cursor2 = len2 - 1;
+        std::ptrdiff_t dest = base2 + len2 - 1;
+
+        arr[dest--] = arr[cursor1--];
+        if (--len1 == 0) {
+            std::copy(tmp, tmp + len2, arr + dest - (len2 - 1));
+            return;
+        }
+        if (len2 == 1) {
+            dest -= len1;
+            cursor1 -= len1;
+            std::copy_backward(arr + cursor1 + 1, arr + cursor1 + 1 + len1, arr + dest + 1 + len1);
+            arr[dest] = tmp[cursor2];
+            return;
+        }
+
+        std::ptrdiff_t gallop = minGallop;
+        while (true) {
+            std::ptrdiff_t count1 = 0;
+            std::ptrdiff_t count2 = 0;
+            bool done = false;
+
+            do {
+                if (less(tmp[cursor2], arr[cursor1])) {
+                    arr[dest--] = arr[cursor1--];
+                    ++count1;
+                    count2 = 0;
+                    if (--len1 == 0) { done = true; break; }
+                }
+                else {
+                    arr[dest--] = tmp[cursor2--];
+                    ++count2;
+                    count1 = 0;
+                    if (--len2 == 1) { done = true; break; }
+                }
+            } while ((count1 | count2) < gallop);
+            if (done) break;
+
+            do {
+                count1 = len1 - gallopRight(tmp[cursor2], arr + base1, len1, len1 - 1, less);
+                if (count1 != 0) {
+                    dest -= count1;
+                    cursor1 -= count1;
+                    len1 -= count1;
+                    std::copy_backward(arr + cursor1 + 1, arr + cursor1 + 1 + count1, arr + dest + 1 + count1);
+                    if (len1 == 0) { done = true; break; }
+                }
+                arr[dest--] = tmp[cursor2--];
+                if (--len2 == 1) { done = true; break; }
+
+                count2 = len2 - gallopLeft(arr[cursor1], tmp, len2, len2 - 1, less);
+                if (count2 != 0) {
+                    dest -= count2;
+                    cursor2 -= count2;
+                    len2 -= count2;
+                    std::copy(tmp + cursor2 + 1, tmp + cursor2 + 1 + count2, arr + dest + 1);
+                    if (len2 <= 1) { done = true; break; }
+                }
+                arr[dest--] = arr[cursor1--];
+                if (--len1 == 0) { done = true; break; }
+                --gallop;
+            } while (count1 >= timSortMinGallop || count2 >= timSortMinGallop);
+            if (done) break;
+
+            if (gallop < 0) gallop = 0;
+            gallop += 2;
+        }
+        minGallop = gallop < 1 ? 1 : gallop;
+
+        if (len2 == 1) {
+            dest -= len1;
+            cursor1 -= len1;
+            std::copy_backward(arr + cursor1 + 1, arr + cursor1 + 1 + len1, arr + dest + 1 + len1);
+            arr[dest] = tmp[cursor2];
+        }
+        else if (len2 == 0) {
+            throw std::invalid_argument("Komparator nie jest scislym porzadkiem slabym");
+        }
+        else {
+            std::copy(tmp, tmp + len2, arr + dest - (len2 - 1));
+        }
+    }
+};
+
+// Rozmiar bufora pomocniczego timSort: scalanie kopiuje zawsze krotsza z dwoch serii.
+inline std::size_t timSortScratchSize(std::size_t size) {
+    return size / 2 + 1;
+}
+
+// Adaptacyjne, stabilne sortowanie przez scalanie naturalnych serii. Krotkie serie sa
+// wydluzane binarnym wstawianiem, kolejnosc scalen wyznacza Powersort, a scalanie galopuje
+// po dlugich blokach z jednej serii. Dla wejsc posortowanych i odwroconych koszt to O(n).
+template <typename E, typename Compare>
+void timSort(E* arr, std::size_t size, const Compare& less, ScratchSpan<E> scratch) {
+    if (size < 2) return;
+
+    const std::ptrdiff_t n = static_cast<std::ptrdiff_t>(size);
+    if (n < timSortMinMerge) {
+        std::ptrdiff_t initRunLen = countRunAndMakeAscending(arr, 0, n, less);
+        binaryInsertionSort(arr, 0, n, initRunLen, less);
+        return;
+    }
+
+    TimSortState<E, Compare> state(arr, requireScratch(scratch, timSortScratchSize(size), "timSort"), less);
+    const std::ptrdiff_t minRun = timSortMinRun(n);
+
+    std::ptrdiff_t lo = 0;
+    while (lo < n) {
+        std::ptrdiff_t runLen = countRunAndMakeAscending(arr, lo, n, less);
+        if (runLen < minRun) {
+            std::ptrdiff_t force = std::min(n - lo, minRun);
+            binaryInsertionSort(arr, lo, lo + force, lo + runLen, less);
+            runLen = force;
+        }
+        state.pushRun(n, lo, runLen);
+        lo += runLen;
+    }
+    state.mergeAll();
+}
+
+template <typename E, typename Compare>
+void timSort(E* arr, std::size_t size, const Compare& less, SortWorkspace<E>& workspace) {
+    timSort(arr, size, less, workspace.reserve(timSortScratchSize(size)));
+}
+
+template <typename E, typename Compare = std::less<E>>
+void timSort(E* arr, std::size_t size, const Compare& less = Compare{}) {
+    if (size < static_cast<std::size_t>(timSortMinMerge)) {
+        timSort(arr, size, less, ScratchSpan<E>{ nullptr, 0 });
+        return;
+    }
+
+    const std::size_t scratchSize = timSortScratchSize(size);
+    E* buffer = new (std::nothrow) E[scratchSize];
+    if (!buffer) {
+        throw std::bad_alloc();
+    }
+
+    try {
+        timSort(arr, size, less, ScratchSpan<E>{ buffer, scratchSize });
+    }
+    catch (...) {
+        delete[] buffer;
+        throw;
+    }
+
+    delete[] buffer;
+}
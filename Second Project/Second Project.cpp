@@ -7,6 +7,8 @@
 #include <queue>
 #include "matrixGraph.hpp"
 #include "listGraph.hpp"
+#include "csrGraph.hpp"
+#include "priorityQueues.hpp"
 
 // Pomocnicza funkcja do generowania krawędzi z losowymi wagami
 std::vector<std::tuple<int, int, double>> generate_random_edges(int V, double density, std::mt19937& rng) {
@@ -33,58 +35,47 @@ std::vector<std::tuple<int, int, double>> generate_random_edges(int V, double de
     return edges;
 }
 
+// Funkcje dijkstra_* przyjmuja typ kolejki z priorityQueues.hpp: Indexed_Dary_Heap<d> (domyslnie d = 4),
+// Pairing_Heap albo Lazy_Binary_Heap (std::priority_queue z leniwym usuwaniem).
+
 // Dijkstra dla Matrix_Graph - all-pairs shortest path 
+template<typename Queue = Indexed_Dary_Heap<4>>
 std::vector<double> dijkstra_matrix_all(const Matrix_Graph<int>& graph, int src, int V) {
     std::vector<double> dist(V, std::numeric_limits<double>::infinity());
-    std::vector<bool> visited(V, false);
     dist[src] = 0.0;
-    using P = std::pair<double, int>;
-    std::priority_queue<P, std::vector<P>, std::greater<P>> pq;
-    pq.emplace(0.0, src);
+    Queue pq(V);
+    pq.push(src, 0.0);
 
     while (!pq.empty()) {
-        double u = pq.top().second;
-        double d = pq.top().first;
-        pq.pop();
-        if (visited[u]) continue;
-        visited[u] = true;
-        for (const auto& nb : graph.neighbours(u)) {
-            double v = nb.first;
-            double w = nb.second;
+        int u = pq.pop();
+        graph.forEachNeighbour(u, [&](int v, double w) {
             if (dist[u] + w < dist[v]) {
                 dist[v] = dist[u] + w;
-                pq.emplace(dist[v], v);
+                pq.pushOrDecrease(v, dist[v]);
             }
-        }
+        });
     }
     return dist;
 }
 
 // Dijkstra dla Matrix_Graph - single-pair shortest path
+template<typename Queue = Indexed_Dary_Heap<4>>
 std::vector<int> dijkstra_matrix_path(const Matrix_Graph<int>& graph, int src, int dest, int V) {
     std::vector<double> dist(V, std::numeric_limits<double>::infinity());
     std::vector<int> prev(V, -1);
-    std::vector<bool> visited(V, false);
     dist[src] = 0.0;
-    using P = std::pair<double, int>;
-    std::priority_queue<P, std::vector<P>, std::greater<P>> pq;
-    pq.emplace(0.0, src);
+    Queue pq(V);
+    pq.push(src, 0.0);
 
     while (!pq.empty()) {
-        double u = pq.top().second;
-        double d = pq.top().first;
-        pq.pop();
-        if (visited[u]) continue;
-        visited[u] = true;
-        for (const auto& nb : graph.neighbours(u)) {
-            double v = nb.first;
-            double w = nb.second;
+        int u = pq.pop();
+        graph.forEachNeighbour(u, [&](int v, double w) {
             if (dist[u] + w < dist[v]) {
                 dist[v] = dist[u] + w;
                 prev[v] = u;
-                pq.emplace(dist[v], v);
+                pq.pushOrDecrease(v, dist[v]);
             }
-        }
+        });
     }
     std::vector<int> path;
     if (dist[dest] == std::numeric_limits<double>::infinity()) return path;
@@ -94,57 +85,89 @@ std::vector<int> dijkstra_matrix_path(const Matrix_Graph<int>& graph, int src, i
 }
 
 // Dijkstra dla List_Graph - all-pairs shortest path 
+template<typename Queue = Indexed_Dary_Heap<4>>
 std::vector<double> dijkstra_list_all(const List_Graph<int>& graph, int src, int V) {
     std::vector<double> dist(V, std::numeric_limits<double>::infinity());
-    std::vector<bool> visited(V, false);
     dist[src] = 0.0;
-    using P = std::pair<double, int>;
-    std::priority_queue<P, std::vector<P>, std::greater<P>> pq;
-    pq.emplace(0.0, src);
+    Queue pq(V);
+    pq.push(src, 0.0);
 
     while (!pq.empty()) {
-        double u = pq.top().second;
-        double d = pq.top().first;
-        pq.pop();
-        if (visited[u]) continue;
-        visited[u] = true;
-        for (const auto& nb : graph.neighbours(u)) {
-            double v = nb.first;
-            double w = nb.second;
+        int u = pq.pop();
+        graph.forEachNeighbour(u, [&](int v, double w) {
             if (dist[u] + w < dist[v]) {
                 dist[v] = dist[u] + w;
-                pq.emplace(dist[v], v);
+                pq.pushOrDecrease(v, dist[v]);
             }
-        }
+        });
     }
     return dist;
 }
 
 // Dijkstra dla List_Graph - single-pair shortest path
+template<typename Queue = Indexed_Dary_Heap<4>>
 std::vector<int> dijkstra_list_path(const List_Graph<int>& graph, int src, int dest, int V) {
     std::vector<double> dist(V, std::numeric_limits<double>::infinity());
     std::vector<int> prev(V, -1);
-    std::vector<bool> visited(V, false);
     dist[src] = 0.0;
-    using P = std::pair<double, int>;
-    std::priority_queue<P, std::vector<P>, std::greater<P>> pq;
-    pq.emplace(0.0, src);
+    Queue pq(V);
+    pq.push(src, 0.0);
 
     while (!pq.empty()) {
-        double u = pq.top().second;
-        double d = pq.top().first;
-        pq.pop();
-        if (visited[u]) continue;
-        visited[u] = true;
-        for (const auto& nb : graph.neighbours(u)) {
-            double v = nb.first;
-            double w = nb.second;
+        int u = pq.pop();
+        graph.forEachNeighbour(u, [&](int v, double w) {
             if (dist[u] + w < dist[v]) {
                 dist[v] = dist[u] + w;
                 prev[v] = u;
-                pq.emplace(dist[v], v);
+                pq.pushOrDecrease(v, dist[v]);
             }
-        }
+        });
+    }
+    std::vector<int> path;
+    if (dist[dest] == std::numeric_limits<double>::infinity()) return path;
+    for (int at = dest; at != -1; at = prev[at]) path.push_back(at);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+// Dijkstra dla CSR_Graph - all-pairs shortest path 
+template<typename Queue = Indexed_Dary_Heap<4>>
+std::vector<double> dijkstra_csr_all(const CSR_Graph<int>& graph, int src, int V) {
+    std::vector<double> dist(V, std::numeric_limits<double>::infinity());
+    dist[src] = 0.0;
+    Queue pq(V);
+    pq.push(src, 0.0);
+
+    while (!pq.empty()) {
+        int u = pq.pop();
+        graph.forEachNeighbour(u, [&](int v, double w) {
+            if (dist[u] + w < dist[v]) {
+                dist[v] = dist[u] + w;
+                pq.pushOrDecrease(v, dist[v]);
+            }
+        });
+    }
+    return dist;
+}
+
+// Dijkstra dla CSR_Graph - single-pair shortest path
+template<typename Queue = Indexed_Dary_Heap<4>>
+std::vector<int> dijkstra_csr_path(const CSR_Graph<int>& graph, int src, int dest, int V) {
+    std::vector<double> dist(V, std::numeric_limits<double>::infinity());
+    std::vector<int> prev(V, -1);
+    dist[src] = 0.0;
+    Queue pq(V);
+    pq.push(src, 0.0);
+
+    while (!pq.empty()) {
+        int u = pq.pop();
+        graph.forEachNeighbour(u, [&](int v, double w) {
+            if (dist[u] + w < dist[v]) {
+                dist[v] = dist[u] + w;
+                prev[v] = u;
+                pq.pushOrDecrease(v, dist[v]);
+            }
+        });
     }
     std::vector<int> path;
     if (dist[dest] == std::numeric_limits<double>::infinity()) return path;
@@ -167,6 +190,7 @@ void benchmark_dijkstra() {
 
             double matrix_all_sum = 0, matrix_path_sum = 0;
             double list_all_sum = 0, list_path_sum = 0;
+            double csr_all_sum = 0, csr_path_sum = 0;
             int repetitions = 100;
             for (int rep = 0; rep < repetitions; ++rep) {
                 auto edges = generate_random_edges(V, density, rng);
@@ -180,6 +204,7 @@ void benchmark_dijkstra() {
                     mgraph.addEdge(u, v, w);
                     lgraph.addEdge(u, v, w);
                 }
+                CSR_Graph<int> cgraph(vertices, edges);
 
                 auto start = std::chrono::high_resolution_clock::now();
                 auto dist_matrix = dijkstra_matrix_all(mgraph, 0, V);
@@ -200,6 +225,16 @@ void benchmark_dijkstra() {
                 auto path_list = dijkstra_list_path(lgraph, 0, V - 1, V);
                 end = std::chrono::high_resolution_clock::now();
                 list_path_sum += std::chrono::duration<double, std::milli>(end - start).count();
+
+                start = std::chrono::high_resolution_clock::now();
+                auto dist_csr = dijkstra_csr_all(cgraph, 0, V);
+                end = std::chrono::high_resolution_clock::now();
+                csr_all_sum += std::chrono::duration<double, std::milli>(end - start).count();
+
+                start = std::chrono::high_resolution_clock::now();
+                auto path_csr = dijkstra_csr_path(cgraph, 0, V - 1, V);
+                end = std::chrono::high_resolution_clock::now();
+                csr_path_sum += std::chrono::duration<double, std::milli>(end - start).count();
             }
 
             std::cout << "Wierzcholki: " << V << ", Gestosc: " << (density * 100) << "%\n";
@@ -207,6 +242,52 @@ void benchmark_dijkstra() {
             std::cout << "MatrixGraph - Dijkstra path: " << (matrix_path_sum / repetitions) << " ms\n";
             std::cout << "ListGraph   - Dijkstra all: " << (list_all_sum / repetitions) << " ms\n";
             std::cout << "ListGraph   - Dijkstra path: " << (list_path_sum / repetitions) << " ms\n";
+            std::cout << "CSRGraph    - Dijkstra all: " << (csr_all_sum / repetitions) << " ms\n";
+            std::cout << "CSRGraph    - Dijkstra path: " << (csr_path_sum / repetitions) << " ms\n";
+            std::cout << "---------------------------------------------\n";
+        }
+    }
+}
+
+template<typename Queue>
+double time_dijkstra_csr(const CSR_Graph<int>& graph, int V) {
+    auto start = std::chrono::high_resolution_clock::now();
+    auto dist = dijkstra_csr_all<Queue>(graph, 0, V);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Porownanie kolejek priorytetowych w Dijkstrze na tym samym grafie CSR
+void benchmark_queues() {
+    std::vector<int> sizes = { 10, 50, 100, 500, 1000 };
+    std::vector<double> densities = { 0.25, 0.5, 0.75, 1.0 };
+    std::random_device rd;
+    std::mt19937 rng(rd());
+
+    for (int V : sizes) {
+        for (double density : densities) {
+            std::vector<int> vertices(V);
+            for (int i = 0; i < V; ++i) vertices[i] = i;
+
+            double lazy_sum = 0, binary_sum = 0, quaternary_sum = 0, octonary_sum = 0, pairing_sum = 0;
+            int repetitions = 20;
+            for (int rep = 0; rep < repetitions; ++rep) {
+                auto edges = generate_random_edges(V, density, rng);
+                CSR_Graph<int> cgraph(vertices, edges);
+
+                lazy_sum += time_dijkstra_csr<Lazy_Binary_Heap>(cgraph, V);
+                binary_sum += time_dijkstra_csr<Indexed_Dary_Heap<2>>(cgraph, V);
+                quaternary_sum += time_dijkstra_csr<Indexed_Dary_Heap<4>>(cgraph, V);
+                octonary_sum += time_dijkstra_csr<Indexed_Dary_Heap<8>>(cgraph, V);
+                pairing_sum += time_dijkstra_csr<Pairing_Heap>(cgraph, V);
+            }
+
+            std::cout << "Wierzcholki: " << V << ", Gestosc: " << (density * 100) << "%\n";
+            std::cout << "Lazy_Binary_Heap       - Dijkstra all: " << (lazy_sum / repetitions) << " ms\n";
+            std::cout << "Indexed_Dary_Heap<2>   - Dijkstra all: " << (binary_sum / repetitions) << " ms\n";
+            std::cout << "Indexed_Dary_Heap<4>   - Dijkstra all: " << (quaternary_sum / repetitions) << " ms\n";
+            std::cout << "Indexed_Dary_Heap<8>   - Dijkstra all: " << (octonary_sum / repetitions) << " ms\n";
+            std::cout << "Pairing_Heap           - Dijkstra all: " << (pairing_sum / repetitions) << " ms\n";
             std::cout << "---------------------------------------------\n";
         }
     }
@@ -253,8 +334,7 @@ void simple_driver_demo() {
     std::cout << "=== MATRIX_GRAPH: Sasiedzi i wagi ===\n";
     for (int i = 0; i < V; ++i) {
         std::cout << "Wierzcholek " << i << " sasiaduje z: ";
-        auto nbs = mgraph.neighbours(i);
-        for (const auto& nb : nbs) {
+        for (const auto& nb : mgraph.neighbourRange(i)) {
             std::cout << nb.first << "(waga: " << nb.second << ") ";
         }
         std::cout << "\n";
@@ -298,8 +378,7 @@ void simple_driver_demo() {
     std::cout << "=== LIST_GRAPH: Sasiedzi i wagi ===\n";
     for (int i = 0; i < V; ++i) {
         std::cout << "Wierzcholek " << i << " sasiaduje z: ";
-        auto nbs = lgraph.neighbours(i);
-        for (const auto& nb : nbs) {
+        for (const auto& nb : lgraph.neighbourRange(i)) {
             std::cout << nb.first << "(waga: " << nb.second << ")  ";
         }
         std::cout << "\n";
@@ -343,6 +422,7 @@ void simple_driver_demo() {
 
 int main() {
     benchmark_dijkstra();
+    benchmark_queues();
     simple_driver_demo();
     return 0;
 }
@@ -0,0 +1,259 @@
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include <algorithm>
+#include <tuple>
+#include <thread>
+#include <exception>
+
+// Ponizej tej liczby krawedzi na watek budowa grafu jest sekwencyjna.
+constexpr std::size_t csrParallelMinEdges = std::size_t(1) << 16;
+
+// Graf nieskierowany w formacie CSR: sasiedzi wierzcholka i leza w targets/weights
+// w przedziale [offsets[i], offsets[i + 1]), jednym ciagiem w pamieci dla calego grafu.
+// Krawedzie dodane pozniej przez addEdge trafiaja do nakladki (listy jak w List_Graph),
+// przydzielanej dopiero przy pierwszym uzyciu; compact() przenosi je do tablic CSR.
+template<typename Vertex>
+class CSR_Graph {
+private:
+    std::vector<Vertex> nodes;
+    std::unordered_map<Vertex, int> idx;
+    std::vector<std::size_t> offsets;
+    std::vector<int> targets;
+    std::vector<double> weights;
+    std::vector<std::vector<std::pair<int, double>>> overlay; // (indeks sasiada, waga)
+
+    void build(const std::vector<std::tuple<int, int, double>>& edges, unsigned threads);
+public:
+    CSR_Graph(const std::vector<Vertex>& nodes);
+    CSR_Graph(const std::vector<Vertex>& nodes, const std::vector<std::tuple<Vertex, Vertex, double>>& edges, unsigned threads = 0);
+    void addEdge(const Vertex& u, const Vertex& v, double weight);
+    void compact();
+    class NeighbourIterator;
+    class NeighbourRange;
+    std::vector<std::pair<Vertex, double>> neighbours(const Vertex& u) const;
+    NeighbourRange neighbourRange(const Vertex& u) const;
+    template<typename Function>
+    void forEachNeighbour(const Vertex& u, Function&& f) const;
+    bool hasEdge(const Vertex& u, const Vertex& v) const;
+    double getWeight(const Vertex& u, const Vertex& v) const;
+};
+
+// Iterator po wierszu CSR, a po jego koncu po krawedziach u z nakladki.
+template<typename Vertex>
+class CSR_Graph<Vertex>::NeighbourIterator {
+    const Vertex* nodes;
+    const int* target;
+    const int* target_end;
+    const double* weight;
+    const std::pair<int, double>* extra;
+public:
+    NeighbourIterator(const Vertex* nodes, const int* target, const int* target_end, const double* weight, const std::pair<int, double>* extra)
+        : nodes(nodes), target(target), target_end(target_end), weight(weight), extra(extra) {}
+    std::pair<const Vertex&, double> operator*() const {
+        if (target != target_end) return { nodes[*target], *weight };
+        return { nodes[extra->first], extra->second };
+    }
+    NeighbourIterator& operator++() {
+        if (target != target_end) { ++target; ++weight; }
+        else ++extra;
+        return *this;
+    }
+    bool operator==(const NeighbourIterator& other) const { return target == other.target && extra == other.extra; }
+    bool operator!=(const NeighbourIterator& other) const { return !(*this == other); }
+};
+
+template<typename Vertex>
+class CSR_Graph<Vertex>::NeighbourRange {
+    NeighbourIterator first, last;
+public:
+    NeighbourRange(NeighbourIterator first, NeighbourIterator last) : first(first), last(last) {}
+    NeighbourIterator begin() const { return first; }
+    NeighbourIterator end() const { return last; }
+    bool empty() const { return first == last; }
+};
+
+template<typename Vertex>
+CSR_Graph<Vertex>::CSR_Graph(const std::vector<Vertex>& nodes) : nodes(nodes), offsets(nodes.size() + 1, 0) {
+    int n = nodes.size();
+    for (int i = 0; i < n; ++i) {
+        idx[nodes[i]] = i;
+    }
+}
+
+template<typename Vertex>
+CSR_Graph<Vertex>::CSR_Graph(const std::vector<Vertex>& nodes, const std::vector<std::tuple<Vertex, Vertex, double>>& edges, unsigned threads)
+    : CSR_Graph(nodes) {
+    std::vector<std::tuple<int, int, double>> indexed(edges.size());
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        indexed[i] = std::make_tuple(idx.at(std::get<0>(edges[i])), idx.at(std::get<1>(edges[i])), std::get<2>(edges[i]));
+    }
+    build(indexed, threads);
+}
+
+// Sortowanie przez zliczanie po wierzcholku zrodlowym (kazda krawedz daje dwa luki). Watek t
+// liczy stopnie w swoim fragmencie listy krawedzi, sumy prefiksowe po (wierzcholek, watek) daja
+// kazdemu watkowi wlasne miejsca zapisu, wiec rozmieszczanie idzie bez synchronizacji, a sasiedzi
+// maja te sama kolejnosc co w List_Graph przy dodawaniu krawedzi po kolei.
+template<typename Vertex>
+void CSR_Graph<Vertex>::build(const std::vector<std::tuple<int, int, double>>& edges, unsigned threads) {
+    std::size_t n = nodes.size();
+    std::size_t m = edges.size();
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(1, m / csrParallelMinEdges)));
+
+    std::vector<std::size_t> counts(static_cast<std::size_t>(threads) * n, 0);
+    auto runThreads = [threads](auto task) {
+        std::vector<std::thread> workers;
+        std::vector<std::exception_ptr> errors(threads);
+        for (unsigned t = 1; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                try { task(t); }
+                catch (...) { errors[t] = std::current_exception(); }
+            });
+        }
+        try { task(0); }
+        catch (...) { errors[0] = std::current_exception(); }
+        for (auto& worker : workers) worker.join();
+        for (auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+    };
+
+    runThreads([&](unsigned t) {
+        std::size_t* count = counts.data() + t * n;
+        for (std::size_t e = m * t / threads; e < m * (t + 1) / threads; ++e) {
+            ++count[std::get<0>(edges[e])];
+            ++count[std::get<1>(edges[e])];
+        }
+    });
+
+    offsets.assign(n + 1, 0);
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        offsets[i] = total;
+        for (unsigned t = 0; t < threads; ++t) {
+            std::size_t count = counts[t * n + i];
+            counts[t * n + i] = total;
+            total += count;
+        }
+    }
+    offsets[n] = total;
+    targets.resize(total);
+    weights.resize(total);
+
+    runThreads([&](unsigned t) {
+        std::size_t* next = counts.data() + t * n;
+        for (std::size_t e = m * t / threads; e < m * (t + 1) / threads; ++e) {
+            int u = std::get<0>(edges[e]);
+            int v = std::get<1>(edges[e]);
+            double w = std::get<2>(edges[e]);
+            std::size_t at = next[u]++;
+            targets[at] = v;
+            weights[at] = w;
+            at = next[v]++;
+            targets[at] = u;
+            weights[at] = w;
+        }
+    });
+}
+
+template<typename Vertex>
+void CSR_Graph<Vertex>::addEdge(const Vertex& u, const Vertex& v, double weight) {
+    int iu = idx.at(u);
+    int iv = idx.at(v);
+    if (overlay.empty()) overlay.resize(nodes.size());
+    overlay[iu].emplace_back(iv, weight);
+    overlay[iv].emplace_back(iu, weight); // dla grafu nieskierowanego
+}
+
+// Dolacza nakladke do tablic CSR: kazdy wiersz to dawny wiersz CSR, a za nim krawedzie
+// z nakladki, czyli ta sama kolejnosc sasiadow co przed compact().
+template<typename Vertex>
+void CSR_Graph<Vertex>::compact() {
+    if (overlay.empty()) return;
+    std::size_t n = nodes.size();
+    std::vector<std::size_t> newOffsets(n + 1, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        newOffsets[i + 1] = newOffsets[i] + (offsets[i + 1] - offsets[i]) + overlay[i].size();
+    }
+
+    std::vector<int> newTargets(newOffsets[n]);
+    std::vector<double> newWeights(newOffsets[n]);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::size_t at = newOffsets[i];
+        for (std::size_t a = offsets[i]; a < offsets[i + 1]; ++a, ++at) {
+            newTargets[at] = targets[a];
+            newWeights[at] = weights[a];
+        }
+        for (const auto& p : overlay[i]) {
+            newTargets[at] = p.first;
+            newWeights[at++] = p.second;
+        }
+    }
+
+    offsets.swap(newOffsets);
+    targets.swap(newTargets);
+    weights.swap(newWeights);
+    overlay.clear();
+    overlay.shrink_to_fit();
+}
+
+template<typename Vertex>
+std::vector<std::pair<Vertex, double>> CSR_Graph<Vertex>::neighbours(const Vertex& u) const {
+    std::vector<std::pair<Vertex, double>> out;
+    forEachNeighbour(u, [&](const Vertex& v, double w) { out.emplace_back(v, w); });
+    return out;
+}
+
+// Zakres sasiadow u wskazujacy wprost na tablice CSR i nakladke; wazny do nastepnego addEdge/compact.
+template<typename Vertex>
+typename CSR_Graph<Vertex>::NeighbourRange CSR_Graph<Vertex>::neighbourRange(const Vertex& u) const {
+    int iu = idx.at(u);
+    const int* first = targets.data() + offsets[iu];
+    const int* last = targets.data() + offsets[iu + 1];
+    const std::pair<int, double>* extra = nullptr;
+    const std::pair<int, double>* extra_end = nullptr;
+    if (!overlay.empty()) {
+        extra = overlay[iu].data();
+        extra_end = extra + overlay[iu].size();
+    }
+    return NeighbourRange(NeighbourIterator(nodes.data(), first, last, weights.data() + offsets[iu], extra),
+                          NeighbourIterator(nodes.data(), last, last, weights.data() + offsets[iu + 1], extra_end));
+}
+
+// Wywoluje f(sasiad, waga) dla kazdego sasiada u; bez alokacji, f jest rozwijana w miejscu.
+template<typename Vertex>
+template<typename Function>
+void CSR_Graph<Vertex>::forEachNeighbour(const Vertex& u, Function&& f) const {
+    int iu = idx.at(u);
+    for (std::size_t a = offsets[iu]; a < offsets[iu + 1]; ++a) {
+        f(nodes[targets[a]], weights[a]);
+    }
+    if (!overlay.empty()) {
+        for (const auto& p : overlay[iu]) {
+            f(nodes[p.first], p.second);
+        }
+    }
+}
+
+template<typename Vertex>
+bool CSR_Graph<Vertex>::hasEdge(const Vertex& u, const Vertex& v) const {
+    return getWeight(u, v) != std::numeric_limits<double>::infinity() || getWeight(v, u) != std::numeric_limits<double>::infinity();
+}
+
+template<typename Vertex>
+double CSR_Graph<Vertex>::getWeight(const Vertex& u, const Vertex& v) const {
+    int iu = idx.at(u);
+    int iv = idx.at(v);
+    for (std::size_t a = offsets[iu]; a < offsets[iu + 1]; ++a) {
+        if (targets[a] == iv) return weights[a];
+    }
+    if (!overlay.empty()) {
+        for (const auto& p : overlay[iu]) {
+            if (p.first == iv) return p.second;
+        }
+    }
+    return std::numeric_limits<double>::infinity(); // brak krawedzi
+}
@@ -13,11 +13,39 @@ private:
 public:
     List_Graph(const std::vector<Vertex>& nodes);
     void addEdge(const Vertex& u, const Vertex& v, double weight);
+    class NeighbourIterator;
+    class NeighbourRange;
     std::vector<std::pair<Vertex, double>> neighbours(const Vertex& u) const;
+    NeighbourRange neighbourRange(const Vertex& u) const;
+    template<typename Function>
+    void forEachNeighbour(const Vertex& u, Function&& f) const;
     bool hasEdge(const Vertex& u, const Vertex& v) const;
     double getWeight(const Vertex& u, const Vertex& v) const;
 };
 
+// Iterator po liscie sasiedztwa bez kopiowania; zwraca pare (sasiad, waga) tworzona w miejscu.
+template<typename Vertex>
+class List_Graph<Vertex>::NeighbourIterator {
+    const Vertex* nodes;
+    const std::pair<int, double>* it;
+public:
+    NeighbourIterator(const Vertex* nodes, const std::pair<int, double>* it) : nodes(nodes), it(it) {}
+    std::pair<const Vertex&, double> operator*() const { return { nodes[it->first], it->second }; }
+    NeighbourIterator& operator++() { ++it; return *this; }
+    bool operator==(const NeighbourIterator& other) const { return it == other.it; }
+    bool operator!=(const NeighbourIterator& other) const { return it != other.it; }
+};
+
+template<typename Vertex>
+class List_Graph<Vertex>::NeighbourRange {
+    NeighbourIterator first, last;
+public:
+    NeighbourRange(NeighbourIterator first, NeighbourIterator last) : first(first), last(last) {}
+    NeighbourIterator begin() const { return first; }
+    NeighbourIterator end() const { return last; }
+    bool empty() const { return first == last; }
+};
+
 template<typename Vertex>
 List_Graph<Vertex>::List_Graph(const std::vector<Vertex>& nodes) : nodes(nodes) {
     int n = nodes.size();
@@ -37,14 +65,27 @@ void List_Graph<Vertex>::addEdge(const Vertex& u, const Vertex& v, double weight
 
 template<typename Vertex>
 std::vector<std::pair<Vertex, double>> List_Graph<Vertex>::neighbours(const Vertex& u) const {
-    int iu = idx.at(u);
     std::vector<std::pair<Vertex, double>> out;
-    for (const auto& p : adj_list[iu]) {
-        out.emplace_back(nodes[p.first], p.second);
-    }
+    forEachNeighbour(u, [&](const Vertex& v, double w) { out.emplace_back(v, w); });
     return out;
 }
 
+// Zakres sasiadow u wskazujacy wprost na adj_list; wazny do nastepnego addEdge.
+template<typename Vertex>
+typename List_Graph<Vertex>::NeighbourRange List_Graph<Vertex>::neighbourRange(const Vertex& u) const {
+    const auto& list = adj_list[idx.at(u)];
+    return NeighbourRange(NeighbourIterator(nodes.data(), list.data()), NeighbourIterator(nodes.data(), list.data() + list.size()));
+}
+
+// Wywoluje f(sasiad, waga) dla kazdego sasiada u; bez alokacji, f jest rozwijana w miejscu.
+template<typename Vertex>
+template<typename Function>
+void List_Graph<Vertex>::forEachNeighbour(const Vertex& u, Function&& f) const {
+    for (const auto& p : adj_list[idx.at(u)]) {
+        f(nodes[p.first], p.second);
+    }
+}
+
 template<typename Vertex>
 bool List_Graph<Vertex>::hasEdge(const Vertex& u, const Vertex& v) const {
     int iu = idx.at(u);
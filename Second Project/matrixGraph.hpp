@@ -2,24 +2,56 @@
 #include <vector>
 #include <unordered_map>
 #include <limits>
+#include <algorithm>
 
 template<typename Vertex>
 class Matrix_Graph {
     std::vector<Vertex> nodes;
     std::unordered_map<Vertex, int> idx;
     std::vector<std::vector<double>> adj_matrix; // macierz wag
+    std::vector<std::vector<int>> row_nonzeros; // kolumny ze skonczona waga w kazdym wierszu, w kolejnosci dodania
 public:
+    class NeighbourIterator;
+    class NeighbourRange;
     Matrix_Graph(const std::vector<Vertex>& nodes);
     void addEdge(const Vertex& u, const Vertex& v, double weight);
     std::vector<std::pair<Vertex, double>> neighbours(const Vertex& u) const;
+    NeighbourRange neighbourRange(const Vertex& u) const;
+    template<typename Function>
+    void forEachNeighbour(const Vertex& u, Function&& f) const;
     bool hasEdge(const Vertex& u, const Vertex& v) const;
     double getWeight(const Vertex& u, const Vertex& v) const;
 };
 
+// Iterator po niezerowych kolumnach wiersza; zwraca pare (sasiad, waga) tworzona w miejscu.
+template<typename Vertex>
+class Matrix_Graph<Vertex>::NeighbourIterator {
+    const Vertex* nodes;
+    const double* row;
+    const int* it;
+public:
+    NeighbourIterator(const Vertex* nodes, const double* row, const int* it) : nodes(nodes), row(row), it(it) {}
+    std::pair<const Vertex&, double> operator*() const { return { nodes[*it], row[*it] }; }
+    NeighbourIterator& operator++() { ++it; return *this; }
+    bool operator==(const NeighbourIterator& other) const { return it == other.it; }
+    bool operator!=(const NeighbourIterator& other) const { return it != other.it; }
+};
+
+template<typename Vertex>
+class Matrix_Graph<Vertex>::NeighbourRange {
+    NeighbourIterator first, last;
+public:
+    NeighbourRange(NeighbourIterator first, NeighbourIterator last) : first(first), last(last) {}
+    NeighbourIterator begin() const { return first; }
+    NeighbourIterator end() const { return last; }
+    bool empty() const { return first == last; }
+};
+
 template<typename Vertex>
 Matrix_Graph<Vertex>::Matrix_Graph(const std::vector<Vertex>& nodes) : nodes(nodes) {
     int n = nodes.size();
     adj_matrix.assign(n, std::vector<double>(n, std::numeric_limits<double>::infinity()));
+    row_nonzeros.resize(n);
     for (int i = 0; i < n; ++i) {
         idx[nodes[i]] = i;
     }
@@ -29,21 +61,54 @@ template<typename Vertex>
 void Matrix_Graph<Vertex>::addEdge(const Vertex& u, const Vertex& v, double weight) {
     int iu = idx.at(u);
     int iv = idx.at(v);
+    bool had_edge = adj_matrix[iu][iv] != std::numeric_limits<double>::infinity();
+    bool has_edge = weight != std::numeric_limits<double>::infinity();
     adj_matrix[iu][iv] = adj_matrix[iv][iu] = weight;
+
+    // Indeks wierszy zmienia sie tylko, gdy krawedz powstaje albo znika (waga nieskonczona).
+    if (had_edge == has_edge) return;
+    if (has_edge) {
+        row_nonzeros[iu].push_back(iv);
+        if (iu != iv) row_nonzeros[iv].push_back(iu);
+    }
+    else {
+        auto& row_u = row_nonzeros[iu];
+        row_u.erase(std::find(row_u.begin(), row_u.end(), iv));
+        if (iu != iv) {
+            auto& row_v = row_nonzeros[iv];
+            row_v.erase(std::find(row_v.begin(), row_v.end(), iu));
+        }
+    }
 }
 
 template<typename Vertex>
 std::vector<std::pair<Vertex, double>> Matrix_Graph<Vertex>::neighbours(const Vertex& u) const {
-    int iu = idx.at(u);
     std::vector<std::pair<Vertex, double>> out;
-    for (int iv = 0; iv < (int)nodes.size(); ++iv) {
-        if (adj_matrix[iu][iv] != std::numeric_limits<double>::infinity()) {
-            out.emplace_back(nodes[iv], adj_matrix[iu][iv]);
-        }
-    }
+    forEachNeighbour(u, [&](const Vertex& v, double w) { out.emplace_back(v, w); });
     return out;
 }
 
+// Zakres sasiadow u po indeksie niezerowych kolumn, bez przegladania calego wiersza.
+template<typename Vertex>
+typename Matrix_Graph<Vertex>::NeighbourRange Matrix_Graph<Vertex>::neighbourRange(const Vertex& u) const {
+    int iu = idx.at(u);
+    const auto& nonzeros = row_nonzeros[iu];
+    const double* row = adj_matrix[iu].data();
+    return NeighbourRange(NeighbourIterator(nodes.data(), row, nonzeros.data()),
+                          NeighbourIterator(nodes.data(), row, nonzeros.data() + nonzeros.size()));
+}
+
+// Wywoluje f(sasiad, waga) dla kazdej krawedzi u: O(stopien) zamiast O(V), bez alokacji.
+template<typename Vertex>
+template<typename Function>
+void Matrix_Graph<Vertex>::forEachNeighbour(const Vertex& u, Function&& f) const {
+    int iu = idx.at(u);
+    const auto& row = adj_matrix[iu];
+    for (int iv : row_nonzeros[iu]) {
+        f(nodes[iv], row[iv]);
+    }
+}
+
 template<typename Vertex>
 bool Matrix_Graph<Vertex>::hasEdge(const Vertex& u, const Vertex& v) const {
     return adj_matrix[idx.at(u)][idx.at(v)] != std::numeric_limits<double>::infinity();
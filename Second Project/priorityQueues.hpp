@@ -0,0 +1,221 @@
+#include <vector>
+#include <queue>
+#include <limits>
+#include <functional>
+#include <utility>
+
+// Kolejki priorytetowe dla algorytmu Dijkstry. Elementy to wierzcholki 0..n-1 z kluczem double;
+// wspolny interfejs: empty(), size(), contains(v), push(v, klucz), decreaseKey(v, klucz),
+// pushOrDecrease(v, klucz) i pop() zwracajacy wierzcholek o najmniejszym kluczu.
+
+// Indeksowany kopiec d-arny: tablica pozycji daje O(1) sprawdzenie obecnosci i decreaseKey
+// w O(log_d n), wiec kopiec ma co najwyzej n elementow. Wieksza arnosc to plytszy kopiec
+// i tansze decreaseKey kosztem wiekszej liczby porownan w pop.
+template<int Arity = 4>
+class Indexed_Dary_Heap {
+    static_assert(Arity >= 2, "arnosc kopca musi byc co najmniej 2");
+
+    std::vector<std::pair<double, int>> heap; // (klucz, wierzcholek)
+    std::vector<int> position;                // miejsce wierzcholka w heap albo -1
+
+    void siftUp(int slot, std::pair<double, int> entry);
+    void siftDown(int slot, std::pair<double, int> entry);
+public:
+    explicit Indexed_Dary_Heap(int n) : position(n, -1) { heap.reserve(n); }
+    bool empty() const { return heap.empty(); }
+    int size() const { return static_cast<int>(heap.size()); }
+    bool contains(int v) const { return position[v] >= 0; }
+    void push(int v, double key);
+    void decreaseKey(int v, double key);
+    void pushOrDecrease(int v, double key);
+    int pop();
+};
+
+// Przesuwa "dziure" w gore, az rodzic nie bedzie wiekszy od entry, i wpisuje tam entry.
+template<int Arity>
+void Indexed_Dary_Heap<Arity>::siftUp(int slot, std::pair<double, int> entry) {
+    while (slot > 0) {
+        int parent = (slot - 1) / Arity;
+        if (!(entry.first < heap[parent].first)) break;
+        heap[slot] = heap[parent];
+        position[heap[slot].second] = slot;
+        slot = parent;
+    }
+    heap[slot] = entry;
+    position[entry.second] = slot;
+}
+
+template<int Arity>
+void Indexed_Dary_Heap<Arity>::siftDown(int slot, std::pair<double, int> entry) {
+    int n = static_cast<int>(heap.size());
+    while (true) {
+        int first = slot * Arity + 1;
+        if (first >= n) break;
+        int last = first + Arity < n ? first + Arity : n;
+        int best = first;
+        for (int child = first + 1; child < last; ++child) {
+            if (heap[child].first < heap[best].first) best = child;
+        }
+        if (!(heap[best].first < entry.first)) break;
+        heap[slot] = heap[best];
+        position[heap[slot].second] = slot;
+        slot = best;
+    }
+    heap[slot] = entry;
+    position[entry.second] = slot;
+}
+
+template<int Arity>
+void Indexed_Dary_Heap<Arity>::push(int v, double key) {
+    heap.emplace_back();
+    siftUp(static_cast<int>(heap.size()) - 1, { key, v });
+}
+
+// Klucz nie wiekszy od obecnego; wiekszy jest ignorowany.
+template<int Arity>
+void Indexed_Dary_Heap<Arity>::decreaseKey(int v, double key) {
+    int slot = position[v];
+    if (key < heap[slot].first) siftUp(slot, { key, v });
+}
+
+template<int Arity>
+void Indexed_Dary_Heap<Arity>::pushOrDecrease(int v, double key) {
+    if (contains(v)) decreaseKey(v, key);
+    else push(v, key);
+}
+
+template<int Arity>
+int Indexed_Dary_Heap<Arity>::pop() {
+    int top = heap.front().second;
+    position[top] = -1;
+    std::pair<double, int> last = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) siftDown(0, last);
+    return top;
+}
+
+// Kopiec parujacy: decreaseKey odcina poddrzewo i laczy je z korzeniem w O(1), pop laczy
+// dzieci korzenia dwuprzebiegowo. Wezly sa w tablicy indeksowanej wierzcholkiem, bez alokacji
+// w trakcie dzialania.
+class Pairing_Heap {
+    struct Node {
+        double key = 0.0;
+        int child = -1;   // pierwsze (najbardziej lewe) dziecko
+        int sibling = -1; // nastepne rodzenstwo
+        int prev = -1;    // poprzednie rodzenstwo albo rodzic, gdy wezel jest pierwszym dzieckiem
+        bool in_heap = false;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> roots; // bufor dzieci korzenia w pop
+    int root = -1;
+    int count = 0;
+
+    int meld(int a, int b);
+public:
+    explicit Pairing_Heap(int n) : nodes(n) {}
+    bool empty() const { return root < 0; }
+    int size() const { return count; }
+    bool contains(int v) const { return nodes[v].in_heap; }
+    void push(int v, double key);
+    void decreaseKey(int v, double key);
+    void pushOrDecrease(int v, double key);
+    int pop();
+};
+
+// Laczy dwa drzewa bez rodzenstwa; korzen o wiekszym kluczu staje sie pierwszym dzieckiem drugiego.
+inline int Pairing_Heap::meld(int a, int b) {
+    if (a < 0) return b;
+    if (b < 0) return a;
+    if (nodes[b].key < nodes[a].key) std::swap(a, b);
+    nodes[b].sibling = nodes[a].child;
+    if (nodes[a].child >= 0) nodes[nodes[a].child].prev = b;
+    nodes[b].prev = a;
+    nodes[a].child = b;
+    return a;
+}
+
+inline void Pairing_Heap::push(int v, double key) {
+    nodes[v] = Node();
+    nodes[v].key = key;
+    nodes[v].in_heap = true;
+    root = meld(root, v);
+    ++count;
+}
+
+// Klucz nie wiekszy od obecnego; wiekszy jest ignorowany.
+inline void Pairing_Heap::decreaseKey(int v, double key) {
+    if (!(key < nodes[v].key)) return;
+    nodes[v].key = key;
+    if (v == root) return;
+
+    Node& node = nodes[v];
+    if (nodes[node.prev].child == v) nodes[node.prev].child = node.sibling;
+    else nodes[node.prev].sibling = node.sibling;
+    if (node.sibling >= 0) nodes[node.sibling].prev = node.prev;
+    node.sibling = node.prev = -1;
+    root = meld(root, v);
+}
+
+inline void Pairing_Heap::pushOrDecrease(int v, double key) {
+    if (contains(v)) decreaseKey(v, key);
+    else push(v, key);
+}
+
+// Dzieci korzenia sa laczone parami od lewej, a potem wyniki od prawej do lewej.
+inline int Pairing_Heap::pop() {
+    int top = root;
+    roots.clear();
+    for (int child = nodes[top].child; child >= 0;) {
+        int next = nodes[child].sibling;
+        nodes[child].sibling = nodes[child].prev = -1;
+        roots.push_back(child);
+        child = next;
+    }
+
+    std::size_t pairs = 0;
+    for (std::size_t i = 0; i < roots.size(); i += 2) {
+        roots[pairs++] = i + 1 < roots.size() ? meld(roots[i], roots[i + 1]) : roots[i];
+    }
+    root = -1;
+    while (pairs > 0) {
+        root = meld(roots[--pairs], root);
+    }
+
+    nodes[top].child = -1;
+    nodes[top].in_heap = false;
+    --count;
+    return top;
+}
+
+// Dotychczasowa kolejka: std::priority_queue z leniwym usuwaniem. pushOrDecrease dodaje nowy wpis,
+// a pop pomija wpisy nieaktualne, wiec kopiec rosnie do O(E); zostawiona do porownan.
+class Lazy_Binary_Heap {
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    std::vector<double> best; // aktualny klucz wierzcholka
+    std::vector<bool> queued;
+    int count = 0;
+public:
+    explicit Lazy_Binary_Heap(int n) : best(n, std::numeric_limits<double>::infinity()), queued(n, false) {}
+    bool empty() const { return count == 0; }
+    int size() const { return count; }
+    bool contains(int v) const { return queued[v]; }
+    void push(int v, double key) { pushOrDecrease(v, key); }
+    void decreaseKey(int v, double key) { pushOrDecrease(v, key); }
+    void pushOrDecrease(int v, double key) {
+        if (queued[v] && !(key < best[v])) return;
+        if (!queued[v]) ++count;
+        queued[v] = true;
+        best[v] = key;
+        heap.emplace(key, v);
+    }
+    int pop() {
+        while (!queued[heap.top().second] || heap.top().first != best[heap.top().second]) heap.pop();
+        int top = heap.top().second;
+        heap.pop();
+        queued[top] = false;
+        --count;
+        return top;
+    }
+};